@@ -0,0 +1,7 @@
+include(../nvOverdrive.pri)
+
+TARGET = nvOverdrive
+TEMPLATE = app
+
+SOURCES += \
+    ../src/main.cpp
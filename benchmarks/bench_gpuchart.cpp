@@ -0,0 +1,56 @@
+#include <QTest>
+#include "testrunner.h"
+#include "include/gpuchart.h"
+#include "include/rollingstats.h"
+
+class BenchGPUChart : public QObject {
+    Q_OBJECT
+
+private slots:
+    void addValue();
+    void rollingStatsAdd_data();
+    void rollingStatsAdd();
+};
+
+void BenchGPUChart::addValue() {
+    GPUChart chart("Core Clock (MHz)", 3000);
+    chart.resize(400, 120);
+    int value = 0;
+    qint64 timestamp = 0;
+
+    QBENCHMARK {
+        chart.addValue(timestamp, value);
+        value = (value + 37) % 3000;
+        timestamp += 1000000;
+    }
+}
+
+// The cost per sample must not grow with the window
+void BenchGPUChart::rollingStatsAdd_data() {
+    QTest::addColumn<int>("window");
+    QTest::newRow("60") << 60;
+    QTest::newRow("600") << 600;
+    QTest::newRow("6000") << 6000;
+    QTest::newRow("60000") << 60000;
+}
+
+void BenchGPUChart::rollingStatsAdd() {
+    QFETCH(int, window);
+    RollingStats stats(window, 3000);
+    int value = 0;
+
+    // Start with a full window so evictions are included, one value per time unit
+    long long time = 0;
+    for (; time < window; time++)
+        stats.add(time, time % 3000);
+
+    QBENCHMARK {
+        stats.add(time++, value);
+        value = (value + 37) % 3000;
+        volatile int p99 = stats.quantile(0.99);
+        Q_UNUSED(p99);
+    }
+}
+
+REGISTER_TEST(BenchGPUChart)
+#include "bench_gpuchart.moc"
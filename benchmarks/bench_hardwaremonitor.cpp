@@ -0,0 +1,32 @@
+#include <QTest>
+#include "testrunner.h"
+#include "include/hardwaremonitor.h"
+
+class BenchHardwareMonitor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void updateCharts();
+};
+
+// Cost of one sample reaching all charts of a GPU
+void BenchHardwareMonitor::updateCharts() {
+    HardwareMonitor monitor(0);
+    for (int i = 0; i < METRIC_COUNT; i++)
+        monitor.addChart(i, METRICS[i].fixedMax);
+    monitor.resize(400, 500);
+
+    GPUSample sample = {};
+    QBENCHMARK {
+        sample.coreTemp = (sample.coreTemp + 1) % 100;
+        sample.coreClock = (sample.coreClock + 37) % 2000;
+        sample.memClock = (sample.memClock + 53) % 7000;
+        sample.fanSpeed = sample.coreTemp;
+        sample.utilization = sample.coreTemp;
+        sample.timestamp += 1000000;
+        monitor.updateCharts(sample);
+    }
+}
+
+REGISTER_TEST(BenchHardwareMonitor)
+#include "bench_hardwaremonitor.moc"
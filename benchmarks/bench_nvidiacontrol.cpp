@@ -0,0 +1,34 @@
+#include <QTest>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/nvidiacontrol.h"
+
+// Overhead of NvidiaControl itself, the fake transport answers from memory
+class BenchNvidiaControl : public QObject {
+    Q_OBJECT
+
+private slots:
+    void getSample();
+    void applyProfile();
+};
+
+void BenchNvidiaControl::getSample() {
+    NvidiaControl nvidia(new FakeNvTransport());
+
+    QBENCHMARK {
+        GPUSample sample = nvidia.getSample(0);
+        Q_UNUSED(sample);
+    }
+}
+
+void BenchNvidiaControl::applyProfile() {
+    NvidiaControl nvidia(new FakeNvTransport());
+    GPUProfile profile(100, 100, 200, true, 60);
+
+    QBENCHMARK {
+        nvidia.applyProfile(0, profile);
+    }
+}
+
+REGISTER_TEST(BenchNvidiaControl)
+#include "bench_nvidiacontrol.moc"
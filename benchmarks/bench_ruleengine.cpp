@@ -0,0 +1,47 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/ruleengine.h"
+
+// Cost of evaluating one sample against many rules, none of which fire
+class BenchRuleEngine : public QObject {
+    Q_OBJECT
+
+private slots:
+    void evaluate_data();
+    void evaluate();
+};
+
+void BenchRuleEngine::evaluate_data() {
+    QTest::addColumn<int>("rules");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("500") << 500;
+}
+
+void BenchRuleEngine::evaluate() {
+    QFETCH(int, rules);
+    QTemporaryDir dir;
+    NvidiaControl nvidia(new FakeNvTransport());
+    Settings settings(dir.filePath("bench.config"));
+
+    for (int i = 0; i < rules; i++) {
+        AlertRule rule(QString("Rule %1").arg(i), QString(), 5, "notify");
+        rule.conditions.append(AlertCondition("coreTemp", ">", 60 + i % 40));
+        rule.conditions.append(AlertCondition("fanSpeed", "<", 30));
+        settings.addAlertRule(rule);
+    }
+    RuleEngine engine(nvidia, settings);
+
+    GPUSample sample = {};
+    sample.coreTemp = 70;
+    sample.fanSpeed = 50;
+
+    QBENCHMARK {
+        engine.evaluate(sample);
+    }
+}
+
+REGISTER_TEST(BenchRuleEngine)
+#include "bench_ruleengine.moc"
@@ -0,0 +1,73 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "include/settings.h"
+
+class BenchSettings : public QObject {
+    Q_OBJECT
+
+private slots:
+    void read_data();
+    void read();
+    void write_data();
+    void write();
+
+private:
+    static const int PROFILES_PER_GPU = 5;
+
+    QTemporaryDir dir;
+    // Creates a config with the given number of GPUs and returns its path
+    QString createConfig(int gpus);
+};
+
+QString BenchSettings::createConfig(int gpus) {
+    // Written directly, creating it through Settings would rewrite the file for every profile
+    QJsonObject profilesObj;
+    for (int gpu = 0; gpu < gpus; gpu++) {
+        QJsonObject gpuProfilesObj;
+        for (int profile = 0; profile < PROFILES_PER_GPU; profile++)
+            gpuProfilesObj[QString("Profile %1").arg(profile)] = GPUProfile(100, profile * 10, profile * 20, true, 50).serialize();
+        profilesObj[QString("GPU-%1").arg(gpu)] = gpuProfilesObj;
+    }
+    QJsonObject settingsObj;
+    settingsObj["Profiles"] = profilesObj;
+
+    QFile file(dir.filePath(QString("bench-%1.config").arg(gpus)));
+    file.open(QIODevice::WriteOnly|QIODevice::Text);
+    file.write(QJsonDocument(settingsObj).toJson());
+    return file.fileName();
+}
+
+void BenchSettings::read_data() {
+    QTest::addColumn<int>("gpus");
+    QTest::newRow("10 gpus") << 10;
+    QTest::newRow("1000 gpus") << 1000;
+    QTest::newRow("5000 gpus") << 5000;
+}
+
+void BenchSettings::read() {
+    QFETCH(int, gpus);
+    QString path = createConfig(gpus);
+
+    QBENCHMARK {
+        Settings settings(path);
+    }
+}
+
+void BenchSettings::write_data() {
+    read_data();
+}
+
+// Every edit serializes and writes the whole configuration
+void BenchSettings::write() {
+    QFETCH(int, gpus);
+    Settings settings(createConfig(gpus));
+    GPUProfile profile(100, 50, 100, false, 0);
+
+    QBENCHMARK {
+        settings.editProfile("GPU-0", profile, "Profile 0");
+    }
+}
+
+REGISTER_TEST(BenchSettings)
+#include "bench_settings.moc"
@@ -0,0 +1,182 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QProcess>
+#include <QTextStream>
+#include <unistd.h>
+#include "testrunner.h"
+#include "include/trayicon.h"
+#include "include/simulatednvtransport.h"
+
+/*
+ * Footprint of the always open window against tray mode. sampleCost is the CPU time of one tick,
+ * including repainting the charts, tray mode also ticks HIDDEN_INTERVAL / SAMPLE_INTERVAL times
+ * less often. residentMemory is the growth of the resident set after a full history of samples,
+ * each mode is measured in a fresh process. processCpu runs the real sampler on a simulated GPU for
+ * MEASURE_SECONDS and reports the user and system CPU time of the process from /proc/self/stat, like a
+ * --simulate instance, in kernel clock ticks (1/CLK_TCK s, named in the row).
+ */
+class BenchTrayMode : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void sampleCost_data();
+    void sampleCost();
+    void residentMemory_data();
+    void residentMemory();
+    void processCpu_data();
+    void processCpu();
+
+private:
+    static const int MEASURE_SECONDS = 60;
+    static const char* CHILD_ENV; // Set in the process measuring a single mode
+
+    QTemporaryDir dir;
+    NvidiaControl* nvidia;
+    Settings* settings;
+    SampleCache* cache;
+    Sampler* sampler;
+    ThrottleTimeline* timeline;
+    SampleHistory* history;
+    TrayIcon* tray;
+    qint64 timestamp;
+
+    void setUpMode(bool window);
+    void tick();
+    static qint64 residentBytes();
+    static qint64 cpuTicks();
+};
+
+void BenchTrayMode::init() {
+    nvidia = new NvidiaControl(new SimulatedNvTransport(1, "bench"));
+    QFile::remove(dir.filePath("bench.config"));
+    settings = new Settings(dir.filePath("bench.config"));
+    cache = new SampleCache();
+    sampler = new Sampler(*nvidia, *cache);
+    timeline = new ThrottleTimeline(*nvidia, *sampler);
+    history = new SampleHistory(1);
+    connect(sampler, &Sampler::sampled, [this](const GPUSample& sample) { history->add(sample); });
+    tray = new TrayIcon(*nvidia, *settings, *sampler, *timeline, *history);
+    timestamp = 0;
+}
+
+void BenchTrayMode::cleanup() {
+    delete tray;
+    delete history;
+    delete timeline;
+    delete sampler;
+    delete cache;
+    delete settings;
+    delete nvidia;
+}
+
+void BenchTrayMode::setUpMode(bool window) {
+    tray->show();
+    if (window) {
+        tray->showWindow();
+        tray->window()->resize(800, 900);
+        QVERIFY(QTest::qWaitForWindowExposed(tray->window()));
+    }
+}
+
+// One tick as the sampler does it, followed by the repaint it causes
+void BenchTrayMode::tick() {
+    GPUSample sample = nvidia->getSample(0);
+    sample.timestamp = timestamp += Sampler::SAMPLE_INTERVAL * 1000;
+    sample.coreTemp = 40 + (timestamp / 1000000) % 40;
+    emit sampler->sampled(sample);
+    emit sampler->updated();
+    QCoreApplication::processEvents();
+}
+
+qint64 BenchTrayMode::residentBytes() {
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.value(1).toLongLong() * sysconf(_SC_PAGESIZE);
+}
+
+qint64 BenchTrayMode::cpuTicks() {
+    QFile stat("/proc/self/stat");
+    if (!stat.open(QIODevice::ReadOnly))
+        return 0;
+    // The command name may contain spaces, the fields are counted from after it
+    QByteArray line = stat.readAll();
+    QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+    return fields.value(11).toLongLong() + fields.value(12).toLongLong(); // utime, stime
+}
+
+void BenchTrayMode::sampleCost_data() {
+    QTest::addColumn<bool>("window");
+    QTest::newRow("tray") << false;
+    QTest::newRow("window") << true;
+}
+
+void BenchTrayMode::sampleCost() {
+    QFETCH(bool, window);
+    setUpMode(window);
+
+    QBENCHMARK {
+        tick();
+    }
+}
+
+void BenchTrayMode::residentMemory_data() {
+    QTest::addColumn<bool>("window");
+    QTest::newRow("tray") << false;
+    QTest::newRow("window") << true;
+}
+
+void BenchTrayMode::residentMemory() {
+    QFETCH(bool, window);
+    if (qEnvironmentVariableIsSet(CHILD_ENV)) {
+        qint64 before = residentBytes();
+        setUpMode(window);
+        for (int i = 0; i < SampleHistory::HISTORY_SIZE; i++)
+            tick();
+        QTextStream(stdout) << "resident " << residentBytes() - before << endl;
+        return;
+    }
+
+    // Memory the other mode left allocated would count towards this one in the same process
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(CHILD_ENV, "1");
+    QProcess child;
+    child.setProcessEnvironment(environment);
+    child.start(QCoreApplication::applicationFilePath(),
+                { "-class", metaObject()->className(), QString("residentMemory:%1").arg(QTest::currentDataTag()) });
+    QVERIFY(child.waitForFinished(60000));
+
+    QByteArray output = child.readAllStandardOutput();
+    int pos = output.indexOf("resident ");
+    QVERIFY2(pos >= 0, output.constData());
+    pos += qstrlen("resident ");
+    QTest::setBenchmarkResult(output.mid(pos, output.indexOf('\n', pos) - pos).toLongLong(), QTest::BytesAllocated);
+}
+
+void BenchTrayMode::processCpu_data() {
+    QTest::addColumn<bool>("window");
+    QString ticks = QString("CPU ticks of 1/%1 s").arg(sysconf(_SC_CLK_TCK));
+    QTest::newRow(qPrintable("tray, " + ticks)) << false;
+    QTest::newRow(qPrintable("window, " + ticks)) << true;
+}
+
+void BenchTrayMode::processCpu() {
+    QFETCH(bool, window);
+    setUpMode(window);
+    sampler->start(sampler->getInterval());
+
+    qint64 before = cpuTicks();
+    QTest::qWait(MEASURE_SECONDS * 1000);
+    sampler->stop();
+
+    QTest::setBenchmarkResult(cpuTicks() - before, QTest::CPUTicks);
+}
+
+const char* BenchTrayMode::CHILD_ENV = "BENCH_TRAYMODE_CHILD";
+
+REGISTER_TEST(BenchTrayMode)
+#include "bench_traymode.moc"
@@ -0,0 +1,25 @@
+include(../nvOverdrive.pri)
+
+QT += testlib
+
+TARGET = benchmarks
+TEMPLATE = app
+
+CONFIG -= app_bundle
+
+# Shares the runner and fakes with the tests
+INCLUDEPATH += ../tests
+
+SOURCES += \
+    main.cpp \
+    ../tests/testrunner.cpp \
+    bench_settings.cpp \
+    bench_gpuchart.cpp \
+    bench_hardwaremonitor.cpp \
+    bench_nvidiacontrol.cpp \
+    bench_ruleengine.cpp \
+    bench_traymode.cpp
+
+HEADERS += \
+    ../tests/testrunner.h \
+    ../tests/fakenvtransport.h
@@ -0,0 +1,30 @@
+#ifndef AGGREGATORVIEW_H
+#define AGGREGATORVIEW_H
+
+#include <QMainWindow>
+#include <QTabWidget>
+#include <QScrollArea>
+#include <QGridLayout>
+#include <QHash>
+#include "hardwaremonitor.h"
+#include "telemetryaggregator.h"
+
+// Shows the charts of every GPU streamed to the aggregator, with a tab per host
+class AggregatorView : public QMainWindow {
+    Q_OBJECT
+
+public:
+    static const int COLUMNS = 4;
+
+    explicit AggregatorView(TelemetryAggregator& aggregator, QWidget* parent = nullptr);
+
+private:
+    QTabWidget* tabs;
+    QHash<QString, QGridLayout*> hostLayouts;
+    QHash<int, HardwareMonitor*> monitors; // stream id -> monitor
+
+    void addStream(int streamId, const QString& host, const QString& uuid, const QString& name);
+    void addSample(const GPUSample& sample);
+};
+
+#endif // AGGREGATORVIEW_H
@@ -0,0 +1,82 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QDebug>
+#include "nvidiacontrol.h"
+#include "samplecache.h"
+#include "settings.h"
+
+/*
+ * Serves a line based control protocol on a local (unix domain) socket, so other
+ * tools can control the running instance without opening their own NV-CONTROL connection.
+ * All socket I/O runs on a worker thread owned by the server.
+ *
+ * Requests (one per line):
+ *   gpus                          list the GPUs
+ *   apply <gpuId> <profile name>  apply a saved profile
+ *   fan <gpuId> <0-100|auto>      set the fan level or return to automatic control,
+ *                                 use comma separated levels to set each fan of the GPU
+ *   stats <gpuId>                 latest sample, number of samples taken and the sampler timing
+ *   subscribe / unsubscribe       start/stop streaming of samples
+ *
+ * Replies are "ok [...]" or "err <message>", samples are streamed as
+ * "sample <gpuId> <temp> <coreClock> <memClock> <fanSpeed> <utilization> <timestamp>",
+ * where the timestamp is in microseconds on the monotonic clock (CLOCK_MONOTONIC).
+ */
+class ControlServer : public QObject {
+    Q_OBJECT
+
+public:
+    ControlServer(NvidiaControl& nvidia, Settings& settings, SampleCache& cache);
+    ~ControlServer();
+
+    static QString socketPath();
+
+    // Send the newest samples in the cache to all subscribers
+    void publish();
+
+private:
+    // Limits for a single client, a client that does not keep up with the
+    // stream simply misses samples instead of growing our buffers
+    static const int MAX_LINE = 1024;
+    static const qint64 MAX_PENDING_BYTES = 8192;
+
+    static const int PROBE_TIMEOUT = 500; // ms to wait for a running instance to answer
+
+    struct Client {
+        bool subscribed = false;
+        bool busy = false; // Waiting for a reply, later requests stay buffered until it is sent
+    };
+
+    NvidiaControl& nvidia;
+    Settings& settings;
+    SampleCache& cache;
+    QThread worker;
+    QObject mainThread; // Context for calls made on the main thread, stays there
+    QLocalServer* server = nullptr;
+    QHash<QLocalSocket*, Client> clients;
+    quint64 lastSequence = 0;
+
+    void listen();
+    void shutdown();
+    void newConnection();
+    void readClient(QLocalSocket* socket);
+    void removeClient(QLocalSocket* socket);
+    QByteArray handleRequest(QLocalSocket* socket, const QByteArray& line);
+    void applyProfile(QLocalSocket* socket, int gpuId, const QString& profileName);
+    void finishApply(const QPointer<QLocalSocket>& socket, int gpuId, bool found, const GPUProfile& profile);
+    QByteArray setFan(int gpuId, const QByteArray& level);
+    QByteArray stats(int gpuId);
+    bool parseGpuId(const QByteArray& arg, int& gpuId);
+    static QByteArray encodeSample(const GPUSample& sample);
+};
+
+#endif // CONTROLSERVER_H
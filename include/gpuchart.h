@@ -3,28 +3,57 @@
 
 #include <QtCharts>
 #include <QChartView>
+#include <QToolTip>
+#include <QMenu>
 #include <memory>
+#include <vector>
+#include "rollingstats.h"
 
 class GPUChart : public QChartView {
 public:
     GPUChart(QString title, int axisYSize, QWidget* parent = nullptr);
 
-    void addValue(int value);
+    // The timestamp is in microseconds, values are plotted against the time since the first one
+    void addValue(qint64 timestamp, int value);
+    // Marks the value shown at the timestamp, the label is shown when hovering the marker.
+    // Markers must be added in time order, times outside the chart are ignored.
+    void addMarker(qint64 timestamp, const QString& label);
+    // Statistics of the selected window in seconds, and the frozen snapshot to compare it with.
+    // The windows span time, so they stay right when the sampling interval changes.
+    void setStatsWindow(int window);
+    void freezeStats();
+    void clearSnapshot();
+protected:
+    void contextMenuEvent(QContextMenuEvent* event) override;
 private:
     // Settings
     static const int CHART_SIZE = 300; // 300 seconds
+    static const std::vector<int> STATS_WINDOWS; // seconds
 
     // Static members for defining the style of the chart
     static bool ST_INIT;
     static QPen PEN_STYLE;
+    static QPen MARKER_STYLE;
     static QFont TITLE_FONT;
     static QFont LABELS_FONT;
     static QMargins MARGINS;
 
     std::unique_ptr<QChart> chart;
     QLineSeries* series;
+    QValueAxis* axisX;
+    QScatterSeries* markers;
+    QMap<qreal, QString> markerLabels;
+    QGraphicsSimpleTextItem* statsText;
+    std::vector<RollingStats> stats;
+    int statsWindow = 0;
+    bool hasSnapshot = false;
+    StatsSummary snapshot;
     QGraphicsSimpleTextItem* currVal;
-    int lastPosX = 0;
+    qint64 startTime = -1;
+
+    void markerHovered(const QPointF& point, bool state);
+    void updateStatsText();
+    static QString formatStats(const StatsSummary& summary);
 };
 
 #endif // GPUCHART_H
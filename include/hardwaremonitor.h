@@ -6,11 +6,7 @@
 #include "ui_hardwaremonitor.h"
 #include "gpuchart.h"
 #include "nvidiacontrol.h"
-
-enum CHARTS {
-    GPU_TEMP, CORE_CLOCK,
-    MEM_CLOCK, FAN_SPEED
-};
+#include "throttledetector.h"
 
 namespace Ui {
 class HardwareMonitor;
@@ -20,19 +16,19 @@ class HardwareMonitor : public QWidget {
     Q_OBJECT
 
 public:
-    explicit HardwareMonitor(NvidiaControl& nvidia, int gpuId, QWidget *parent = 0);
+    explicit HardwareMonitor(int gpuId, QWidget *parent = 0);
 
-    NvidiaControl& nvidia;
     QVBoxLayout* chartsLayout;
-    QTimer* updater;
-    QMap<CHARTS, GPUChart*> charts;
+    GPUChart* charts[METRIC_COUNT] = {}; // Indexed like METRICS, null if the metric has no chart
 
-    void addChart(CHARTS chart);
+    void addChart(int metric, int maxValue);
+    void addThrottleEvent(const ThrottleEvent& event);
+    void updateCharts(const GPUSample& sample);
+    void setTitle(const QString& title);
 private:
     int gpuId;
+    int chartCount = 0;
     std::unique_ptr<Ui::HardwareMonitor> ui;
-
-    void updateCharts();
 };
 
 #endif // HARDWAREMONITOR_H
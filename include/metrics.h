@@ -0,0 +1,79 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QMetaType>
+#include "nvtransport.h"
+
+// A single reading of the monitored sensors of a GPU, the fan speed is the highest of all fans
+struct GPUSample {
+    int gpuId;
+    int coreTemp;
+    int coreClock;
+    int memClock;
+    int fanSpeed;
+    int utilization;
+    qint64 timestamp; // Microseconds on the monotonic clock (CLOCK_MONOTONIC), in the middle of the read
+};
+Q_DECLARE_METATYPE(GPUSample)
+
+// Where the value of a metric is read from
+enum MetricSource {
+    GPU_ATTRIBUTE,    // Integer attribute of the GPU
+    COOLER_ATTRIBUTE, // Integer attribute of every cooler of the GPU, the highest is used
+    GPU_STRING        // String attribute of the GPU
+};
+
+// Where the upper bound of a chart comes from, the fixed maximum is used if the device does not report it
+enum MetricRange {
+    FIXED_RANGE,
+    CORE_THRESHOLD_RANGE, // Shutdown temperature
+    CORE_CLOCK_RANGE,     // Highest clock of the performance levels plus the highest offset
+    MEM_CLOCK_RANGE
+};
+
+struct MetricDescriptor {
+    const char* name;  // Used by the control socket and alert rules
+    const char* title;
+    const char* unit;
+    int GPUSample::* field;
+    MetricSource source;
+    unsigned int nvAttribute;
+    int (*unpack)(int value);              // For integer sources
+    int (*parse)(const QString& value);    // For string sources
+    MetricRange range;
+    int fixedMax;
+};
+
+namespace Metrics {
+inline int value(int value) { return value; }
+// NV_CTRL_GPU_CURRENT_CLOCK_FREQS packs the core clock in the high and the memory clock in the low word
+inline int highWord(int value) { return (value >> 16) & 0xFFFF; }
+inline int lowWord(int value) { return value & 0xFFFF; }
+int graphicsUtilization(const QString& value);
+}
+
+/*
+ * Every monitored metric. Sampling, the charts, the telemetry stream, the control socket and alert rules
+ * all walk this table, so a metric is added by adding a field to GPUSample and a row here. Metrics that
+ * unpack the same attribute must be next to each other, the attribute is then read once per sample.
+ * The order is also the order of the fields in the telemetry stream.
+ */
+constexpr MetricDescriptor METRICS[] = {
+    { "coreTemp", "GPU Temperature", u8"\u2103", &GPUSample::coreTemp, GPU_ATTRIBUTE,
+      NV_CTRL_GPU_CORE_TEMPERATURE, Metrics::value, nullptr, CORE_THRESHOLD_RANGE, 100 },
+    { "coreClock", "Core Clock", "MHz", &GPUSample::coreClock, GPU_ATTRIBUTE,
+      NV_CTRL_GPU_CURRENT_CLOCK_FREQS, Metrics::highWord, nullptr, CORE_CLOCK_RANGE, 3000 },
+    { "memClock", "Memory Clock", "MHz", &GPUSample::memClock, GPU_ATTRIBUTE,
+      NV_CTRL_GPU_CURRENT_CLOCK_FREQS, Metrics::lowWord, nullptr, MEM_CLOCK_RANGE, 6000 },
+    { "fanSpeed", "Fan Speed", "%", &GPUSample::fanSpeed, COOLER_ATTRIBUTE,
+      NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL, Metrics::value, nullptr, FIXED_RANGE, 100 },
+    { "utilization", "GPU Utilization", "%", &GPUSample::utilization, GPU_STRING,
+      NV_CTRL_STRING_GPU_UTILIZATION, nullptr, Metrics::graphicsUtilization, FIXED_RANGE, 100 }
+};
+constexpr int METRIC_COUNT = sizeof(METRICS) / sizeof(METRICS[0]);
+
+// Index of the metric with the given name, -1 if there is none
+int metricIndex(const QString& name);
+
+#endif // METRICS_H
@@ -2,18 +2,14 @@
 #define NVIDIACONTROL_H
 
 #include <QString>
+#include <QStringList>
 #include <QVector>
-#include <X11/Xlib.h>
-#include <NVCtrl/NVCtrl.h>
-#include <NVCtrl/NVCtrlLib.h>
-
-class NvException : public std::exception {
-private:
-    QString message;
-public:
-    NvException(const QString &message) { this->message = "NvidiaControl: " + message; }
-    const char* what() const throw() override { return message.toLatin1().data(); }
-};
+#include <QMutex>
+#include <QMetaType>
+#include <memory>
+#include "nvtransport.h"
+#include "metrics.h"
+#include "settings.h"
 
 struct GPU {
     int id;
@@ -21,6 +17,7 @@ struct GPU {
     QString vBiosVer;
     QString driverVer;
     QString UUID;
+    QVector<int> coolers; // Cooler target ids of the fans on this GPU
 };
 
 struct ClockFreqs {
@@ -43,23 +40,23 @@ struct ClockFreqRanges {
 
 class NvidiaControl {
 private:
-    // These must be static because xlib is a C api
-    static QString xLibErr;
-    static int xLibErrorHandler(Display* d, XErrorEvent* e);
-    static QString getXlibErr();
-
     QVector<GPU> gpus;
-    Display *dpy = nullptr;
-    int eventBase, errorBase;
+    std::unique_ptr<NvTransport> transport;
+    // Serializes access to the transport, which may be used from several threads
+    QMutex transportLock;
 
     QString queryStringAttribute(int gpuId, int targetType, unsigned int nvAttribute);
     int queryAttribute(int gpuId, int targetType, unsigned int nvAttribute);
     NVCTRLAttributeValidValuesRec queryValidAttributes(int gpuId, int targetType, unsigned int nvAttribute);
     void setAttribute(int gpuId, int targetType, unsigned int nvAttribute, int value);
+    QVector<int> queryCoolers(int gpuId);
+    QVector<int> queryCoolerAttribute(int gpuId, unsigned int nvAttribute);
+    void setCoolerLevels(int gpuId, const QVector<int>& levels);
+    int queryHighestPerformanceClock(int gpuId, const QString& key);
 
 public:
-    NvidiaControl();
-    ~NvidiaControl();
+    // Takes ownership of the transport, by default the X server is used
+    explicit NvidiaControl(NvTransport* transport = nullptr);
 
     const QVector<GPU>& getGpus();
     const GPU& getGpu(int gpuId);
@@ -67,10 +64,17 @@ public:
     ClockFreqs getClocks(int gpuId);
     void setClocks(int gpuId, int coreClock, int memClock);
     int getCoreTemp(int gpuId);
+    int getSlowdownTemp(int gpuId);
+    int getUtilization(int gpuId);
     ClockFreqs getCurrentClocks(int gpuId);
     CoolerInfo getCoolerInfo(int gpuId);
+    QVector<CoolerInfo> getCoolers(int gpuId);
     void setManualFanSpeed(int gpuId, int speed);
+    void setManualFanSpeeds(int gpuId, const QVector<int>& speeds);
     void setFanSpeedAuto(int gpuId);
+    void applyProfile(int gpuId, const GPUProfile& profile);
+    GPUSample getSample(int gpuId);
+    int getMetricRange(int gpuId, const MetricDescriptor& metric);
 };
 
 #endif // NVIDIACONTROL_H
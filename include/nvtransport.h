@@ -0,0 +1,66 @@
+#ifndef NVTRANSPORT_H
+#define NVTRANSPORT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <X11/Xlib.h>
+#include <NVCtrl/NVCtrl.h>
+#include <NVCtrl/NVCtrlLib.h>
+
+class NvException : public std::exception {
+private:
+    QByteArray message; // Owned here, what() must not point into a temporary
+public:
+    NvException(const QString &message) { this->message = ("NvidiaControl: " + message).toUtf8(); }
+    const char* what() const throw() override { return message.constData(); }
+};
+
+struct NvAttributeWrite {
+    int targetId;
+    int targetType;
+    unsigned int nvAttribute;
+    int value;
+};
+
+// The raw NV-CONTROL attribute calls used by NvidiaControl, so they can be
+// replaced by a fake device in tests and benchmarks
+class NvTransport {
+public:
+    virtual ~NvTransport() {}
+
+    virtual int queryTargetCount(int targetType) = 0;
+    virtual QString queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) = 0;
+    virtual int queryAttribute(int targetId, int targetType, unsigned int nvAttribute) = 0;
+    virtual NVCTRLAttributeValidValuesRec queryValidAttributes(int targetId, int targetType, unsigned int nvAttribute) = 0;
+    virtual QByteArray queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) = 0;
+    virtual void setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) = 0;
+    // Sets several attributes at once, errors are only reported after all writes
+    virtual void setAttributes(const QVector<NvAttributeWrite>& writes) = 0;
+};
+
+// Talks to the NV-CONTROL extension of the X server
+class XNvTransport : public NvTransport {
+private:
+    // These must be static because xlib is a C api
+    static QString xLibErr;
+    static int xLibErrorHandler(Display* d, XErrorEvent* e);
+    static QString getXlibErr();
+
+    Display *dpy = nullptr;
+    int eventBase, errorBase;
+
+public:
+    XNvTransport();
+    ~XNvTransport();
+
+    int queryTargetCount(int targetType) override;
+    QString queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) override;
+    int queryAttribute(int targetId, int targetType, unsigned int nvAttribute) override;
+    NVCTRLAttributeValidValuesRec queryValidAttributes(int targetId, int targetType, unsigned int nvAttribute) override;
+    QByteArray queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) override;
+    void setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) override;
+    void setAttributes(const QVector<NvAttributeWrite>& writes) override;
+};
+
+#endif // NVTRANSPORT_H
@@ -10,6 +10,9 @@
 #include "settings.h"
 #include "hardwaremonitor.h"
 #include "nvidiacontrol.h"
+#include "sampler.h"
+#include "throttledetector.h"
+#include "samplehistory.h"
 
 namespace Ui {
 class Panel;
@@ -19,12 +22,16 @@ class Panel : public QMainWindow {
     Q_OBJECT
 
 public:
-    explicit Panel(NvidiaControl& nvidia, Settings& settings, QWidget *parent = 0);
+    // The charts start with the samples in the history
+    Panel(NvidiaControl& nvidia, Settings& settings, Sampler& sampler, ThrottleTimeline& throttleTimeline, SampleHistory& history, QWidget *parent = 0);
 
 private:
     std::unique_ptr<Ui::Panel> ui;
     NvidiaControl& nvidia;
     Settings& settings;
+    Sampler& sampler;
+    ThrottleTimeline& throttleTimeline;
+    SampleHistory& history;
     const GPU* selectedGPU;
     HardwareMonitor* hwMon = nullptr;
 
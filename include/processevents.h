@@ -0,0 +1,75 @@
+#ifndef PROCESSEVENTS_H
+#define PROCESSEVENTS_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QSocketNotifier>
+
+// Reports processes starting and exiting. Process names are the kernel "comm"
+// name, which is the executable name truncated to 15 characters.
+class ProcessEventSource : public QObject {
+    Q_OBJECT
+
+public:
+    static const int COMM_LENGTH = 15;
+
+    explicit ProcessEventSource(QObject* parent = nullptr) : QObject(parent) {}
+
+    // Starts reporting events, processes that are already running are reported
+    // as started. Returns false if this source is not available on the system.
+    virtual bool start() = 0;
+
+    static QString readProcessName(int pid);
+
+signals:
+    void processStarted(int pid, const QString& name);
+    void processExited(int pid);
+
+protected:
+    // Reads the pids of all running processes from /proc, names are not read
+    static QSet<int> listProcesses();
+    // Lists /proc and reports the processes that started or exited since the known pids were taken
+    void reportChanges(QSet<int>& known);
+};
+
+// Event driven source using the netlink process connector. Needs CAP_NET_ADMIN.
+// When the socket overruns and events are lost, /proc is listed once to catch up.
+class NetlinkProcessSource : public ProcessEventSource {
+    Q_OBJECT
+
+public:
+    explicit NetlinkProcessSource(QObject* parent = nullptr) : ProcessEventSource(parent) {}
+    ~NetlinkProcessSource();
+
+    bool start() override;
+
+private:
+    int sock = -1;
+    QSocketNotifier* notifier = nullptr;
+    QSet<int> known; // Running processes as far as the events and the last listing tell
+
+    void readEvents();
+};
+
+// Fallback source that periodically lists /proc. Only the names of processes
+// that were not seen on the previous scan are read.
+class ProcScanProcessSource : public ProcessEventSource {
+    Q_OBJECT
+
+public:
+    static const int SCAN_INTERVAL = 2000; // ms
+
+    explicit ProcScanProcessSource(QObject* parent = nullptr);
+
+    bool start() override;
+
+private:
+    QTimer* timer;
+    QSet<int> known;
+
+    void scan();
+};
+
+#endif // PROCESSEVENTS_H
@@ -0,0 +1,88 @@
+#ifndef PROFILECOMPARISON_H
+#define PROFILECOMPARISON_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include "nvidiacontrol.h"
+#include "settings.h"
+
+// One metric over the kept samples of a profile
+struct MetricSummary {
+    int count = 0;
+    double mean = 0;
+    double stddev = 0;
+    double p50 = 0;
+    double p95 = 0;
+};
+
+// Difference of a profile from the first one, with 95% confidence intervals.
+// Phases are the independent observations, samples within a phase are correlated.
+struct MetricDifference {
+    double mean = 0;
+    double meanLow = 0;
+    double meanHigh = 0;
+    double p95 = 0;
+    double p95Low = 0;
+    double p95High = 0;
+    bool hasInterval = false; // Needs at least two phases of both profiles
+};
+
+/*
+ * Alternates the profiles of a GPU on a fixed schedule and collects the samples of each phase.
+ * Every round runs each profile for one phase, odd rounds in reverse order (A B B A ...) so slow
+ * drifts like a heating room affect all profiles alike. The first samples of a phase are
+ * discarded, they still show the previous profile settling.
+ */
+class ProfileComparison : public QObject {
+    Q_OBJECT
+
+public:
+    ProfileComparison(NvidiaControl& nvidia, int gpuId, const QStringList& profileNames, const QVector<GPUProfile>& profiles,
+                      int phaseSamples, int warmupSamples, int rounds, QObject* parent = nullptr);
+
+    // Applies the profile of the first phase
+    void start();
+    void addSample(const GPUSample& sample);
+    bool isFinished() const;
+    int completedPhases() const;
+    // Why the run stopped early, empty if it did not
+    const QString& getError() const;
+
+    // Statistics of the completed phases, indexed by profile and then like METRICS
+    QVector<QVector<MetricSummary>> summaries() const;
+    QVector<QVector<MetricDifference>> differences() const;
+    QString report() const;
+
+signals:
+    void phaseStarted(int phase, const QString& profileName);
+    void finished();
+    // A profile could not be applied, no more samples are taken
+    void failed(const QString& error);
+
+private:
+    static const int BOOTSTRAP_ITERATIONS = 1000;
+
+    struct Phase {
+        int profile;
+        std::vector<int> values[METRIC_COUNT];
+    };
+
+    NvidiaControl& nvidia;
+    int gpuId;
+    QStringList profileNames;
+    QVector<GPUProfile> profiles;
+    int phaseSamples;
+    int warmupSamples;
+    int rounds;
+    QVector<Phase> phases;
+    int currentPhase = 0;
+    int phaseSeen = 0;
+    QString error;
+
+    void startPhase();
+    QVector<const Phase*> phasesOf(int profile) const;
+};
+
+#endif // PROFILECOMPARISON_H
@@ -0,0 +1,54 @@
+#ifndef PROFILESWITCHER_H
+#define PROFILESWITCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QVector>
+#include <QPair>
+#include <QDebug>
+#include "nvidiacontrol.h"
+#include "settings.h"
+#include "processevents.h"
+
+/*
+ * Applies the profiles of the process rules in Settings while a matching process runs.
+ * When several matching processes run at once, the one started last wins. When the
+ * last one exits the GPU returns to its "apply on start" profile, or to the defaults.
+ */
+class ProfileSwitcher : public QObject {
+    Q_OBJECT
+
+public:
+    // If no source is given, the netlink source is used if available, otherwise /proc is scanned
+    ProfileSwitcher(NvidiaControl& nvidia, Settings& settings, ProcessEventSource* source = nullptr, QObject* parent = nullptr);
+
+    void start();
+    void reloadRules();
+
+    // The profile applied by a rule for a GPU, empty if no rule is active
+    QString getActiveProfile(int gpuId) const;
+
+signals:
+    void profileSwitched(int gpuId, const QString& profileName);
+
+private:
+    struct Target {
+        int gpuId;
+        QString profileName;
+    };
+
+    NvidiaControl& nvidia;
+    Settings& settings;
+    ProcessEventSource* source;
+
+    QHash<QString, QVector<Target>> rules;       // process name -> targets
+    QHash<int, QVector<Target>> running;          // pid -> targets it activated
+    QMap<int, QVector<QPair<int, QString>>> active; // gpuId -> (pid, profile) in start order
+
+    void processStarted(int pid, const QString& name);
+    void processExited(int pid);
+    void applyProfile(int gpuId, const QString& profileName);
+};
+
+#endif // PROFILESWITCHER_H
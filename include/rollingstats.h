@@ -0,0 +1,54 @@
+#ifndef ROLLINGSTATS_H
+#define ROLLINGSTATS_H
+
+#include <deque>
+#include <vector>
+#include <utility>
+
+struct StatsSummary {
+    long long window;
+    int count;
+    int min;
+    int max;
+    double mean;
+    int p95;
+    int p99;
+};
+
+/*
+ * Min, max, mean and quantiles over the values of the last window of time, all updated in
+ * amortized constant time per value. Times are in any unit as long as the window uses the same,
+ * they must not decrease. Min and max use monotonic deques, quantiles a sliding histogram over
+ * [0, rangeMax] with a fixed number of buckets, so their precision is rangeMax / buckets and
+ * the cost does not depend on the number of values in the window.
+ */
+class RollingStats {
+public:
+    static const int DEFAULT_BUCKETS = 256;
+
+    RollingStats(long long window, int rangeMax, int buckets = DEFAULT_BUCKETS);
+
+    // Values older than time - window are evicted
+    void add(long long time, int value);
+
+    long long getWindow() const;
+    int count() const;
+    int min() const;
+    int max() const;
+    double mean() const;
+    int quantile(double q) const;
+    StatsSummary summary() const;
+
+private:
+    long long window;
+    int rangeMax;
+    std::deque<std::pair<long long, int>> values;   // (time, value) of the window
+    std::vector<int> histogram;
+    std::deque<std::pair<long long, int>> minQueue; // (time, value) ascending values
+    std::deque<std::pair<long long, int>> maxQueue; // (time, value) descending values
+    long long sum = 0;
+
+    int bucket(int value) const;
+};
+
+#endif // ROLLINGSTATS_H
@@ -0,0 +1,69 @@
+#ifndef RULEENGINE_H
+#define RULEENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QProcess>
+#include <QDebug>
+#include "nvidiacontrol.h"
+#include "settings.h"
+
+/*
+ * Evaluates the alert rules in Settings on every sample. The rules are compiled once into a flat
+ * array of comparisons, so a sample costs one pass over that array and a check per rule and GPU.
+ * A rule fires once when its conditions have held for its duration, measured with the sample
+ * timestamps so it does not depend on the sampling rate, and again only after the conditions
+ * stopped holding in between.
+ */
+class RuleEngine : public QObject {
+    Q_OBJECT
+
+public:
+    RuleEngine(NvidiaControl& nvidia, Settings& settings, QObject* parent = nullptr);
+
+    // Compiles the rules in Settings, invalid rules are skipped with a warning
+    void compile();
+    void evaluate(const GPUSample& sample);
+    int ruleCount() const;
+
+signals:
+    void notification(const QString& message);
+    void ruleTriggered(const QString& ruleName, int gpuId);
+
+private:
+    enum Op : quint8 { GT, GE, LT, LE, EQ, NE };
+    enum Action : quint8 { APPLY_PROFILE, FAN_AUTO, RUN_COMMAND, NOTIFY };
+
+    struct Instruction {
+        int GPUSample::* field;
+        Op op;
+        int value;
+    };
+
+    struct CompiledRule {
+        int first;       // First instruction
+        int count;       // Number of instructions
+        int gpuId;       // -1 for all GPUs
+        qint64 holdTime; // Microseconds the conditions must hold before firing
+        Action action;
+        int ruleIndex;   // Into rules
+    };
+
+    struct HoldState {
+        qint64 since = -1; // Timestamp of the first matching sample, -1 if the conditions do not hold
+        bool fired = false;
+    };
+
+    NvidiaControl& nvidia;
+    Settings& settings;
+    QVector<Instruction> program;
+    QVector<CompiledRule> compiled;
+    QVector<AlertRule> rules;
+    QVector<HoldState> held; // Per compiled rule and GPU
+    int gpuCount;
+
+    bool compileRule(const AlertRule& rule, CompiledRule& compiledRule);
+    void runAction(const CompiledRule& rule, int gpuId);
+};
+
+#endif // RULEENGINE_H
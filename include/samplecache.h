@@ -0,0 +1,44 @@
+#ifndef SAMPLECACHE_H
+#define SAMPLECACHE_H
+
+#include <QReadWriteLock>
+#include <QMap>
+#include <QVector>
+#include <cmath>
+#include "nvidiacontrol.h"
+
+// How well the sampler keeps its schedule, times are in microseconds
+struct SamplerTiming {
+    quint64 ticks = 0;
+    quint64 missedTicks = 0;  // Deadlines skipped because an earlier tick ran past them
+    qint64 lastLateness = 0;  // Time from the deadline to the start of the tick
+    qint64 maxLateness = 0;
+    double meanLateness = 0;
+    double latenessM2 = 0;    // Sum of squared differences from the mean
+    qint64 maxReadTime = 0;   // Longest read of one GPU, sample timestamps are within half of it
+
+    // Standard deviation of the lateness
+    double jitter() const { return ticks > 1 ? std::sqrt(latenessM2 / (ticks - 1)) : 0; }
+};
+
+// Holds the most recent sample of every GPU, so that readers on other threads
+// (like the control server) never have to talk to the driver themselves
+class SampleCache {
+private:
+    mutable QReadWriteLock lock;
+    QMap<int, GPUSample> latest;
+    QMap<int, quint64> sampleCounts;
+    quint64 sequence = 0;
+    SamplerTiming timing;
+
+public:
+    void update(const GPUSample& sample);
+    bool getLatest(int gpuId, GPUSample& sample) const;
+    quint64 getSampleCount(int gpuId) const;
+    QVector<GPUSample> getAll() const;
+    quint64 getSequence() const;
+    void updateTiming(const SamplerTiming& timing);
+    SamplerTiming getTiming() const;
+};
+
+#endif // SAMPLECACHE_H
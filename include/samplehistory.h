@@ -0,0 +1,36 @@
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <QVector>
+#include <vector>
+#include "metrics.h"
+
+// Keeps the recent samples of every GPU in a compact form, so the charts can be rebuilt after
+// they were torn down. Values are stored as 16 bit integers and times as the gap to the
+// previous sample in milliseconds, 16 bytes per sample instead of the 32 of a GPUSample.
+class SampleHistory {
+public:
+    static const int HISTORY_SIZE = 300; // Samples per GPU
+
+    explicit SampleHistory(int gpuCount);
+
+    void add(const GPUSample& sample);
+    // Oldest first
+    QVector<GPUSample> get(int gpuId) const;
+
+private:
+    struct CompactSample {
+        quint32 gap; // ms since the previous sample of the GPU
+        qint16 values[METRIC_COUNT];
+    };
+
+    struct Ring {
+        std::vector<CompactSample> samples;
+        int next = 0;
+        qint64 lastTimestamp = -1;
+    };
+
+    QVector<Ring> rings;
+};
+
+#endif // SAMPLEHISTORY_H
@@ -0,0 +1,53 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include "nvidiacontrol.h"
+#include "samplecache.h"
+
+// Periodically reads the sensors of all GPUs and publishes the samples to the
+// cache, so the driver is polled once per tick no matter how many consumers there are.
+// Ticks are scheduled against absolute deadlines, so a late tick does not shift the ones after it.
+class Sampler : public QObject {
+    Q_OBJECT
+
+public:
+    static const int SAMPLE_INTERVAL = 1000; // ms
+
+    explicit Sampler(NvidiaControl& nvidia, SampleCache& cache, QObject* parent = nullptr);
+
+    // Microseconds on the monotonic clock, the time base of sample timestamps
+    static qint64 monotonicTime();
+
+    void start(int interval = SAMPLE_INTERVAL);
+    void stop();
+    // Changes the interval without restarting, the next tick is one new interval from now at the latest
+    void setInterval(int interval);
+    int getInterval() const;
+    const SamplerTiming& getTiming() const;
+
+signals:
+    // Emitted for every GPU on each tick
+    void sampled(const GPUSample& sample);
+    // Emitted once all GPUs have been sampled on a tick
+    void updated();
+    // Emitted when deadlines passed without a tick, they are skipped rather than made up
+    void ticksMissed(int count);
+
+private:
+    NvidiaControl& nvidia;
+    SampleCache& cache;
+    QTimer* timer;
+    qint64 interval = 0;     // us
+    qint64 nextDeadline = 0; // us
+    SamplerTiming timing;
+
+    void tick();
+    void schedule();
+    void sampleAll();
+};
+
+#endif // SAMPLER_H
@@ -5,15 +5,17 @@
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QVector>
 #include <QMap>
 #include <memory>
 
 class SettingsException : public std::exception {
 private:
-    QString message;
+    QByteArray message;
 public:
-    SettingsException(const QString &message) { this->message = "Settings: " + message; }
-    const char* what() const throw() override { return message.toLatin1().data(); }
+    SettingsException(const QString &message) { this->message = ("Settings: " + message).toUtf8(); }
+    const char* what() const throw() override { return message.constData(); }
 };
 
 struct GPUProfile {
@@ -22,27 +24,75 @@ struct GPUProfile {
     int memClock;
     bool manualFanControl;
     int fanSpeed;
+    QVector<int> fanSpeeds; // Optional speed of each fan, overrides fanSpeed
 
     GPUProfile(int powerLimit = 100, int coreClock = 0, int memClock = 0, bool manualFanControl = false, int fanSpeed = 0);
     GPUProfile(const QJsonObject& json);
     QJsonObject serialize() const;
 };
 
+// Switches a GPU to a profile while a process with the given executable name runs
+struct ProcessRule {
+    QString executable;
+    QString gpuUUID;
+    QString profileName;
+
+    ProcessRule(const QString& executable = QString(), const QString& gpuUUID = QString(), const QString& profileName = QString());
+    ProcessRule(const QJsonObject& json);
+    QJsonObject serialize() const;
+};
+
+// A comparison of a sensor value, e.g. "coreTemp" ">" 85
+struct AlertCondition {
+    QString metric;
+    QString op;
+    int value;
+
+    AlertCondition(const QString& metric = QString(), const QString& op = QString(), int value = 0);
+    AlertCondition(const QJsonObject& json);
+    QJsonObject serialize() const;
+};
+
+// Runs an action when all conditions hold for a GPU for the given number of seconds
+struct AlertRule {
+    QString name;
+    QString gpuUUID; // Empty for all GPUs
+    QVector<AlertCondition> conditions;
+    int duration;
+    QString action;   // "profile", "fanAuto", "command" or "notify"
+    QString argument; // Profile name, or the command to run
+
+    AlertRule(const QString& name = QString(), const QString& gpuUUID = QString(), int duration = 0,
+              const QString& action = QString(), const QString& argument = QString());
+    AlertRule(const QJsonObject& json);
+    QJsonObject serialize() const;
+};
+
 class Settings {
 private:
     QMap<QString, QString> applyOnStart;
     QMap<QString, QMap<QString, GPUProfile>> gpuProfiles;
+    QVector<ProcessRule> processRules;
+    QVector<AlertRule> alertRules;
     std::unique_ptr<QFile> configFile;
 
     void createDefaultSettings();
     void writeSettings();
     void writeAppSettings(QJsonObject& json);
     void writeProfiles(QJsonObject& json);
+    void writeProcessRules(QJsonObject& json);
+    void writeAlertRules(QJsonObject& json);
     void readSettings();
     void readAppSettings(const QJsonObject& json);
     void readProfiles(const QJsonObject& json);
+    void readProcessRules(const QJsonObject& json);
+    void readAlertRules(const QJsonObject& json);
 public:
     Settings();
+    explicit Settings(const QString& fileName);
+
+    // Path of the configuration the default constructor uses
+    static QString defaultFileName();
 
     const QMap<QString, GPUProfile>& getGPUProfiles(const QString& gpuUUID);
     void newProfile(const QString& gpuUUID, const QString& profileName);
@@ -51,6 +101,12 @@ public:
     const QString getApplyOnStart(const QString& gpuUUID);
     void setApplyOnStart(const QString& gpuUUID, const QString& profileName, bool enable);
     const GPUProfile& getProfile(const QString& gpuUUID, const QString& profileName);
+    const QVector<ProcessRule>& getProcessRules();
+    void addProcessRule(const ProcessRule& rule);
+    void removeProcessRule(int index);
+    const QVector<AlertRule>& getAlertRules();
+    void addAlertRule(const AlertRule& rule);
+    void removeAlertRule(int index);
 };
 
 #endif // SETTINGS_H
@@ -0,0 +1,36 @@
+#ifndef SIMULATEDNVTRANSPORT_H
+#define SIMULATEDNVTRANSPORT_H
+
+#include <QHash>
+#include <QElapsedTimer>
+#include "nvtransport.h"
+
+// A made up device with changing sensor readings, for running without NVIDIA
+// hardware (--simulate). Clock offsets raise the clocks and the temperature, other
+// settings are kept but have no effect.
+class SimulatedNvTransport : public NvTransport {
+private:
+    int gpuCount;
+    QString idPrefix;
+    QElapsedTimer clock;
+    QHash<quint64, int> attributes;
+
+    static quint64 key(int targetId, int targetType, unsigned int nvAttribute);
+    // A slow wave between min and max, phase shifted per GPU
+    int wave(int gpuId, int min, int max, double periodSec);
+    int coreOffset(int gpuId);
+
+public:
+    // GPU UUIDs start with the prefix, so several simulated instances can be told apart
+    SimulatedNvTransport(int gpuCount, const QString& idPrefix);
+
+    int queryTargetCount(int targetType) override;
+    QString queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) override;
+    int queryAttribute(int targetId, int targetType, unsigned int nvAttribute) override;
+    NVCTRLAttributeValidValuesRec queryValidAttributes(int targetId, int targetType, unsigned int nvAttribute) override;
+    QByteArray queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) override;
+    void setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) override;
+    void setAttributes(const QVector<NvAttributeWrite>& writes) override;
+};
+
+#endif // SIMULATEDNVTRANSPORT_H
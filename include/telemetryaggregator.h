@@ -0,0 +1,51 @@
+#ifndef TELEMETRYAGGREGATOR_H
+#define TELEMETRYAGGREGATOR_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QDebug>
+#include "telemetryframe.h"
+
+/*
+ * Receives telemetry from collectors. Each GPU of each host becomes a stream with an id that
+ * stays the same when the host reconnects. Samples are reported with gpuId set to the stream id.
+ * Memory is bounded: at most MAX_STREAMS GPUs and MAX_CONNECTIONS hosts are accepted, and only
+ * a partial frame and TelemetryDecoder::MAX_GPUS streams are kept per connection.
+ */
+class TelemetryAggregator : public QObject {
+    Q_OBJECT
+
+public:
+    static const int MAX_STREAMS = 1024;
+    static const int MAX_CONNECTIONS = 512;
+
+    explicit TelemetryAggregator(QObject* parent = nullptr);
+
+    bool listen(quint16 port, const QHostAddress& address = QHostAddress::Any);
+    quint16 serverPort() const;
+    int streamCount() const;
+
+signals:
+    void streamAdded(int streamId, const QString& host, const QString& uuid, const QString& name);
+    void sampleReceived(const GPUSample& sample);
+
+private:
+    struct Connection {
+        TelemetryDecoder decoder;
+        QString host;
+        QHash<int, int> streams; // GPU index -> stream id
+    };
+
+    QTcpServer* server;
+    QHash<QTcpSocket*, Connection> connections;
+    QHash<QString, int> streamIds; // "host/uuid" -> stream id
+
+    void newConnection();
+    void readConnection(QTcpSocket* socket);
+    void dropConnection(QTcpSocket* socket);
+    bool handleFrame(Connection& connection, const TelemetryFrame& frame);
+};
+
+#endif // TELEMETRYAGGREGATOR_H
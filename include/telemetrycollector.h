@@ -0,0 +1,43 @@
+#ifndef TELEMETRYCOLLECTOR_H
+#define TELEMETRYCOLLECTOR_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+#include "nvidiacontrol.h"
+#include "sampler.h"
+#include "telemetryframe.h"
+
+// Streams the samples of this host to an aggregator, reconnecting when the connection drops.
+// Samples taken while disconnected, or while the aggregator is not keeping up, are dropped.
+class TelemetryCollector : public QObject {
+    Q_OBJECT
+
+public:
+    static const int MIN_RECONNECT_DELAY = 1000;  // ms
+    static const int MAX_RECONNECT_DELAY = 30000; // ms
+    static const qint64 MAX_PENDING_BYTES = 64 * 1024;
+
+    TelemetryCollector(NvidiaControl& nvidia, Sampler& sampler, const QString& hostName,
+                       const QString& address, quint16 port, QObject* parent = nullptr);
+
+    void start();
+    bool isConnected() const;
+
+private:
+    NvidiaControl& nvidia;
+    QString hostName;
+    QString address;
+    quint16 port;
+    QTcpSocket* socket;
+    QTimer* reconnectTimer;
+    int reconnectDelay = MIN_RECONNECT_DELAY;
+    TelemetryEncoder encoder;
+
+    void connectToAggregator();
+    void connected();
+    void disconnected();
+    void sendSample(const GPUSample& sample);
+};
+
+#endif // TELEMETRYCOLLECTOR_H
@@ -0,0 +1,64 @@
+#ifndef TELEMETRYFRAME_H
+#define TELEMETRYFRAME_H
+
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "nvidiacontrol.h"
+
+/*
+ * Wire format of the telemetry streamed from collectors to an aggregator.
+ * Every frame is <varint length><type><payload>. A stream starts with a hello frame naming
+ * the host, followed by a GPU frame for each GPU before its samples. Sample values are
+ * zigzag varint deltas from the previous sample of the same GPU, or from zero in key frames,
+ * followed by the timestamp encoded the same way as a 64 bit value. A stream may announce at
+ * most MAX_GPUS GPUs, samples of GPUs it did not announce make it corrupt.
+ */
+enum TelemetryFrameType : quint8 {
+    HELLO_FRAME = 1, GPU_FRAME = 2, SAMPLE_FRAME = 3
+};
+
+struct TelemetryFrame {
+    TelemetryFrameType type;
+    QString host;           // Hello frames
+    int gpuIndex = 0;       // GPU and sample frames
+    QString uuid;           // GPU frames
+    QString name;           // GPU frames
+    GPUSample sample = {};  // Sample frames, sample.gpuId is the GPU index
+};
+
+class TelemetryEncoder {
+public:
+    static const int KEYFRAME_INTERVAL = 60;
+
+    QByteArray hello(const QString& host);
+    QByteArray gpu(int gpuIndex, const QString& uuid, const QString& name);
+    QByteArray sample(const GPUSample& sample);
+    // Must be called when the stream restarts, the following samples are key frames
+    void reset();
+
+private:
+    QHash<int, GPUSample> previous;
+    QHash<int, int> sinceKeyframe;
+};
+
+class TelemetryDecoder {
+public:
+    static const int MAX_FRAME_SIZE = 4096;
+    static const int MAX_GPUS = 64;
+
+    // Decodes all complete frames in the received data, incomplete frames are kept until
+    // the rest arrives. Returns false if the stream is corrupt and must be dropped.
+    bool feed(const QByteArray& data, QVector<TelemetryFrame>& frames);
+
+private:
+    QByteArray buffer;
+    QSet<int> announced;
+    QHash<int, GPUSample> previous;
+
+    bool decodeFrame(const char* data, int size, TelemetryFrame& frame);
+};
+
+#endif // TELEMETRYFRAME_H
@@ -0,0 +1,85 @@
+#ifndef THROTTLEDETECTOR_H
+#define THROTTLEDETECTOR_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+#include "nvidiacontrol.h"
+#include "sampler.h"
+
+enum ThrottleCause {
+    NO_THROTTLE, THERMAL_THROTTLE,
+    POWER_THROTTLE, CLOCK_COLLAPSE
+};
+
+struct ThrottleEvent {
+    int gpuId;
+    ThrottleCause cause;
+    QDateTime start;
+    QDateTime end;  // Invalid while the event is ongoing
+    qint64 timestamp; // Of the sample that started the event, in microseconds (CLOCK_MONOTONIC)
+    int peakClock;  // Sustained core clock before the event
+    int minClock;   // Lowest core clock during the event
+    int maxTemp;    // Highest temperature during the event
+
+    static QString causeName(ThrottleCause cause);
+};
+
+/*
+ * Detects throttling of a single GPU from its sample stream, using constant state. Hold and decay
+ * use the sample timestamps, so the detection does not depend on the sampling interval.
+ * NV-CONTROL does not report throttle reasons, so the cause is inferred: the core clock
+ * dropping below its sustained peak while the GPU is busy is thermal throttling when the
+ * temperature is near the slowdown threshold, and a power/voltage limit otherwise.
+ */
+class ThrottleDetector {
+public:
+    static const int LOAD_THRESHOLD = 80;       // % utilization for the GPU to count as busy
+    static const int THERMAL_MARGIN = 3;        // degrees below the slowdown threshold
+    static const int FALLBACK_SLOWDOWN_TEMP = 85;
+    static const qint64 HOLD_TIME = 1000000;    // µs a cause must persist before reporting
+    static constexpr double DROP_RATIO = 0.05;      // drop from peak that counts as throttling
+    static constexpr double COLLAPSE_RATIO = 0.5;   // drop from peak that counts as a collapse
+    static constexpr double PEAK_DECAY = 0.001;     // per second, lets the peak follow real changes
+
+    explicit ThrottleDetector(int slowdownTemp = 0);
+
+    // Returns true if an event started or ended, in which case event holds it
+    bool addSample(const GPUSample& sample, const QDateTime& time, ThrottleEvent& event);
+
+private:
+    int slowdownTemp;
+    double peakClock = 0;
+    qint64 lastTimestamp = -1;
+    ThrottleCause pending = NO_THROTTLE;
+    qint64 pendingSince = 0;
+    bool inEvent = false;
+    ThrottleEvent current;
+
+    ThrottleCause classify(const GPUSample& sample) const;
+};
+
+// Runs a detector for every GPU and keeps a bounded timeline of throttle events
+class ThrottleTimeline : public QObject {
+    Q_OBJECT
+
+public:
+    static const int MAX_EVENTS = 200;
+
+    ThrottleTimeline(NvidiaControl& nvidia, Sampler& sampler, QObject* parent = nullptr);
+
+    const QList<ThrottleEvent>& getEvents() const;
+
+signals:
+    void eventStarted(const ThrottleEvent& event);
+    void eventEnded(const ThrottleEvent& event);
+
+private:
+    QMap<int, ThrottleDetector> detectors;
+    QList<ThrottleEvent> events;
+
+    void addSample(const GPUSample& sample);
+};
+
+#endif // THROTTLEDETECTOR_H
@@ -0,0 +1,51 @@
+#ifndef TRAYICON_H
+#define TRAYICON_H
+
+#include <QObject>
+#include <QSystemTrayIcon>
+#include <QMenu>
+#include <QPointer>
+#include <QPainter>
+#include "panel.h"
+#include "samplehistory.h"
+
+/*
+ * Tray mode: the tray icon shows the temperature of the first GPU and the tooltip a readout of
+ * every GPU. The window, and with it the charts, only exists while it is open. While it is
+ * closed the sampler runs at the hidden interval, and the charts are rebuilt from the history
+ * when the window opens again.
+ */
+class TrayIcon : public QObject {
+    Q_OBJECT
+
+public:
+    static const int HIDDEN_INTERVAL = 5000; // ms
+
+    TrayIcon(NvidiaControl& nvidia, Settings& settings, Sampler& sampler, ThrottleTimeline& throttleTimeline,
+             SampleHistory& history, int hiddenInterval = HIDDEN_INTERVAL, QObject* parent = nullptr);
+    ~TrayIcon();
+
+    void show();
+    void showWindow();
+    void hideWindow();
+    Panel* window() const;
+    void showNotification(const QString& message);
+
+private:
+    NvidiaControl& nvidia;
+    Settings& settings;
+    Sampler& sampler;
+    ThrottleTimeline& throttleTimeline;
+    SampleHistory& history;
+    int hiddenInterval;
+    QSystemTrayIcon* tray;
+    QMenu menu;
+    QPointer<Panel> panel;
+    QMap<int, GPUSample> latest;
+    int iconTemp = -1;
+
+    void activated(QSystemTrayIcon::ActivationReason reason);
+    void updateReadout();
+};
+
+#endif // TRAYICON_H
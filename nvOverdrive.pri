@@ -0,0 +1,67 @@
+# Sources shared by the application, tests and benchmarks
+QT       += core gui widgets charts network
+
+CONFIG += c++14
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/src/nvidiacontrol.cpp \
+    $$PWD/src/xnvtransport.cpp \
+    $$PWD/src/gpuchart.cpp \
+    $$PWD/src/settings.cpp \
+    $$PWD/src/hardwaremonitor.cpp \
+    $$PWD/src/panel.cpp \
+    $$PWD/src/samplecache.cpp \
+    $$PWD/src/sampler.cpp \
+    $$PWD/src/controlserver.cpp \
+    $$PWD/src/processevents.cpp \
+    $$PWD/src/profileswitcher.cpp \
+    $$PWD/src/throttledetector.cpp \
+    $$PWD/src/rollingstats.cpp \
+    $$PWD/src/simulatednvtransport.cpp \
+    $$PWD/src/telemetryframe.cpp \
+    $$PWD/src/telemetrycollector.cpp \
+    $$PWD/src/telemetryaggregator.cpp \
+    $$PWD/src/aggregatorview.cpp \
+    $$PWD/src/ruleengine.cpp \
+    $$PWD/src/metrics.cpp \
+    $$PWD/src/profilecomparison.cpp \
+    $$PWD/src/samplehistory.cpp \
+    $$PWD/src/trayicon.cpp
+
+HEADERS += \
+    $$PWD/include/nvidiacontrol.h \
+    $$PWD/include/nvtransport.h \
+    $$PWD/include/gpuchart.h \
+    $$PWD/include/settings.h \
+    $$PWD/include/hardwaremonitor.h \
+    $$PWD/include/panel.h \
+    $$PWD/include/samplecache.h \
+    $$PWD/include/sampler.h \
+    $$PWD/include/controlserver.h \
+    $$PWD/include/processevents.h \
+    $$PWD/include/profileswitcher.h \
+    $$PWD/include/throttledetector.h \
+    $$PWD/include/rollingstats.h \
+    $$PWD/include/simulatednvtransport.h \
+    $$PWD/include/telemetryframe.h \
+    $$PWD/include/telemetrycollector.h \
+    $$PWD/include/telemetryaggregator.h \
+    $$PWD/include/aggregatorview.h \
+    $$PWD/include/ruleengine.h \
+    $$PWD/include/metrics.h \
+    $$PWD/include/profilecomparison.h \
+    $$PWD/include/samplehistory.h \
+    $$PWD/include/trayicon.h
+
+FORMS += \
+    $$PWD/include/ui/hardwaremonitor.ui \
+    $$PWD/include/ui/panel.ui
+
+unix {
+    LIBS += -lX11
+    LIBS += -lXNVCtrl
+}
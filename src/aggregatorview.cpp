@@ -0,0 +1,42 @@
+#include "include/aggregatorview.h"
+
+AggregatorView::AggregatorView(TelemetryAggregator& aggregator, QWidget* parent) : QMainWindow(parent) {
+    setWindowTitle(QString("nvOverdrive aggregator (port %1)").arg(aggregator.serverPort()));
+    resize(1280, 800);
+
+    tabs = new QTabWidget(this);
+    setCentralWidget(tabs);
+
+    connect(&aggregator, &TelemetryAggregator::streamAdded, this, &AggregatorView::addStream);
+    connect(&aggregator, &TelemetryAggregator::sampleReceived, this, &AggregatorView::addSample);
+}
+
+void AggregatorView::addStream(int streamId, const QString& host, const QString& uuid, const QString& name) {
+    QGridLayout* layout = hostLayouts.value(host);
+    if (layout == nullptr) {
+        QScrollArea* scrollArea = new QScrollArea(tabs);
+        QWidget* hostWidget = new QWidget(scrollArea);
+        layout = new QGridLayout(hostWidget);
+        scrollArea->setWidget(hostWidget);
+        scrollArea->setWidgetResizable(true);
+        tabs->addTab(scrollArea, host);
+        hostLayouts[host] = layout;
+    }
+
+    HardwareMonitor* monitor = new HardwareMonitor(streamId, layout->parentWidget());
+    monitor->setTitle(name + "\n" + uuid);
+    monitor->setMinimumSize(300, 500);
+    // The limits of remote devices are not streamed
+    for (int i = 0; i < METRIC_COUNT; i++)
+        monitor->addChart(i, METRICS[i].fixedMax);
+
+    int index = layout->count();
+    layout->addWidget(monitor, index / COLUMNS, index % COLUMNS);
+    monitors[streamId] = monitor;
+}
+
+void AggregatorView::addSample(const GPUSample& sample) {
+    HardwareMonitor* monitor = monitors.value(sample.gpuId);
+    if (monitor != nullptr)
+        monitor->updateCharts(sample);
+}
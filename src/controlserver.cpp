@@ -0,0 +1,214 @@
+#include "include/controlserver.h"
+
+ControlServer::ControlServer(NvidiaControl& nvidia, Settings& settings, SampleCache& cache) : nvidia(nvidia), settings(settings), cache(cache) {
+    moveToThread(&worker);
+    connect(&worker, &QThread::started, this, &ControlServer::listen);
+    // Sockets must be destroyed on the thread they live in
+    connect(&worker, &QThread::finished, this, &ControlServer::shutdown, Qt::DirectConnection);
+    worker.start();
+}
+
+ControlServer::~ControlServer() {
+    worker.quit();
+    worker.wait();
+}
+
+QString ControlServer::socketPath() {
+    QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    return runtimeDir + "/nvOverdrive.sock";
+}
+
+void ControlServer::listen() {
+    server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &ControlServer::newConnection);
+
+    // Only take the socket over if nobody answers on it, it is then left behind by an
+    // instance that did not exit cleanly
+    QLocalSocket probe;
+    probe.connectToServer(socketPath());
+    if (probe.waitForConnected(PROBE_TIMEOUT)) {
+        qWarning() << "ControlServer: another instance is already running on" << socketPath();
+        return;
+    }
+    QLocalServer::removeServer(socketPath());
+    if (!server->listen(socketPath()))
+        qWarning() << "ControlServer: failed to listen on" << socketPath() << server->errorString();
+}
+
+void ControlServer::shutdown() {
+    for (QLocalSocket* socket : clients.keys())
+        delete socket;
+    clients.clear();
+    delete server;
+    server = nullptr;
+}
+
+void ControlServer::newConnection() {
+    while (QLocalSocket* socket = server->nextPendingConnection()) {
+        clients.insert(socket, Client());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readClient(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+    }
+}
+
+void ControlServer::removeClient(QLocalSocket* socket) {
+    clients.remove(socket);
+    socket->deleteLater();
+}
+
+void ControlServer::readClient(QLocalSocket* socket) {
+    while (!clients.value(socket).busy && socket->canReadLine()) {
+        QByteArray line = socket->readLine(MAX_LINE).trimmed();
+        if (line.isEmpty())
+            continue;
+        // Requests answered later return nothing here
+        QByteArray reply = handleRequest(socket, line);
+        if (!reply.isEmpty())
+            socket->write(reply);
+    }
+
+    // Drop clients that send garbage without line breaks, or pile up requests while one is pending
+    if (socket->bytesAvailable() > (clients.value(socket).busy ? MAX_PENDING_BYTES : MAX_LINE))
+        socket->disconnectFromServer();
+}
+
+QByteArray ControlServer::handleRequest(QLocalSocket* socket, const QByteArray& line) {
+    QList<QByteArray> args = line.split(' ');
+    const QByteArray& cmd = args[0];
+    int gpuId;
+
+    if (cmd == "gpus") {
+        QByteArray reply;
+        for (const GPU& gpu : nvidia.getGpus())
+            reply += QString("gpu %1 %2 %3\n").arg(gpu.id).arg(gpu.UUID).arg(gpu.productName).toUtf8();
+        return reply + "ok\n";
+    } else if (cmd == "subscribe") {
+        clients[socket].subscribed = true;
+        return "ok\n";
+    } else if (cmd == "unsubscribe") {
+        clients[socket].subscribed = false;
+        return "ok\n";
+    } else if (cmd == "apply" && args.size() >= 3 && parseGpuId(args[1], gpuId)) {
+        // Profile names may contain spaces
+        QString profileName = QString::fromUtf8(line.mid(line.indexOf(' ', cmd.size() + 1) + 1));
+        applyProfile(socket, gpuId, profileName);
+        return QByteArray();
+    } else if (cmd == "fan" && args.size() == 3 && parseGpuId(args[1], gpuId)) {
+        return setFan(gpuId, args[2]);
+    } else if (cmd == "stats" && args.size() == 2 && parseGpuId(args[1], gpuId)) {
+        return stats(gpuId);
+    }
+    return "err invalid request\n";
+}
+
+bool ControlServer::parseGpuId(const QByteArray& arg, int& gpuId) {
+    bool ok;
+    gpuId = arg.toInt(&ok);
+    return ok && gpuId >= 0 && gpuId < nvidia.getGpus().size();
+}
+
+void ControlServer::applyProfile(QLocalSocket* socket, int gpuId, const QString& profileName) {
+    // Settings is not thread safe, so the profile is looked up on the main thread. Blocking on that
+    // could deadlock with the destructor waiting for this thread, so the result is posted back.
+    clients[socket].busy = true;
+    QPointer<QLocalSocket> client(socket);
+    QString gpuUUID = nvidia.getGpu(gpuId).UUID;
+    QMetaObject::invokeMethod(&mainThread, [this, client, gpuId, gpuUUID, profileName]() {
+        const auto& profiles = settings.getGPUProfiles(gpuUUID);
+        bool found = profiles.contains(profileName);
+        GPUProfile profile = found ? profiles.value(profileName) : GPUProfile();
+        QMetaObject::invokeMethod(this, [this, client, gpuId, found, profile]() {
+            finishApply(client, gpuId, found, profile);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void ControlServer::finishApply(const QPointer<QLocalSocket>& socket, int gpuId, bool found, const GPUProfile& profile) {
+    // The client may have gone away in the meantime
+    if (!socket || !clients.contains(socket))
+        return;
+
+    QByteArray reply = "ok\n";
+    if (!found) {
+        reply = "err no such profile\n";
+    } else {
+        try {
+            nvidia.applyProfile(gpuId, profile);
+        } catch (NvException& e) {
+            reply = QByteArray("err ") + e.what() + "\n";
+        }
+    }
+    socket->write(reply);
+    clients[socket].busy = false;
+
+    // Continue with the requests that arrived meanwhile
+    readClient(socket);
+}
+
+QByteArray ControlServer::setFan(int gpuId, const QByteArray& level) {
+    try {
+        if (level == "auto") {
+            nvidia.setFanSpeedAuto(gpuId);
+            return "ok\n";
+        }
+
+        // One level for all fans, or a comma separated level for each fan
+        QVector<int> speeds;
+        for (const QByteArray& fanLevel : level.split(',')) {
+            bool ok;
+            int speed = fanLevel.toInt(&ok);
+            if (!ok || speed < 0 || speed > 100)
+                return "err invalid fan level\n";
+            speeds.append(speed);
+        }
+        nvidia.setManualFanSpeeds(gpuId, speeds);
+    } catch (NvException& e) {
+        return QByteArray("err ") + e.what() + "\n";
+    }
+    return "ok\n";
+}
+
+QByteArray ControlServer::stats(int gpuId) {
+    GPUSample sample;
+    if (!cache.getLatest(gpuId, sample))
+        return "err no samples yet\n";
+
+    SamplerTiming timing = cache.getTiming();
+    return encodeSample(sample) + QString("ok samples=%1 ticks=%2 missed=%3 lateness_us=%4 lateness_max_us=%5 jitter_us=%6 read_max_us=%7\n")
+            .arg(cache.getSampleCount(gpuId))
+            .arg(timing.ticks)
+            .arg(timing.missedTicks)
+            .arg(timing.meanLateness, 0, 'f', 1)
+            .arg(timing.maxLateness)
+            .arg(timing.jitter(), 0, 'f', 1)
+            .arg(timing.maxReadTime)
+            .toUtf8();
+}
+
+void ControlServer::publish() {
+    // Several updates may have queued up while we were busy, only send the newest
+    quint64 sequence = cache.getSequence();
+    if (sequence == lastSequence)
+        return;
+    lastSequence = sequence;
+
+    // Encode once, every subscriber gets the same bytes
+    QByteArray frame;
+    for (const GPUSample& sample : cache.getAll())
+        frame += encodeSample(sample);
+
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        QLocalSocket* socket = it.key();
+        if (it.value().subscribed && socket->bytesToWrite() < MAX_PENDING_BYTES)
+            socket->write(frame);
+    }
+}
+
+// "sample <gpuId>" followed by the metrics in table order and the timestamp
+QByteArray ControlServer::encodeSample(const GPUSample& sample) {
+    QByteArray line = "sample " + QByteArray::number(sample.gpuId);
+    for (const MetricDescriptor& metric : METRICS)
+        line += ' ' + QByteArray::number(sample.*metric.field);
+    return line + ' ' + QByteArray::number(sample.timestamp) + '\n';
+}
@@ -2,14 +2,18 @@
 
 bool GPUChart::ST_INIT = false;
 QPen GPUChart::PEN_STYLE;
+QPen GPUChart::MARKER_STYLE;
 QFont GPUChart::TITLE_FONT;
 QFont GPUChart::LABELS_FONT;
 QMargins GPUChart::MARGINS;
+const std::vector<int> GPUChart::STATS_WINDOWS = { 60, CHART_SIZE, 600 };
 
 GPUChart::GPUChart(QString title, int axisYSize, QWidget* parent) : QChartView(parent) {
     if (!ST_INIT) {
         PEN_STYLE.setColor(Qt::red);
         PEN_STYLE.setWidth(1);
+        MARKER_STYLE.setColor(QColor(255, 140, 0));
+        MARKER_STYLE.setWidth(2);
         TITLE_FONT.setPixelSize(12);
         LABELS_FONT.setPixelSize(12);
         MARGINS.setBottom(0);
@@ -24,9 +28,16 @@ GPUChart::GPUChart(QString title, int axisYSize, QWidget* parent) : QChartView(p
     series = new QLineSeries(this);
     series->setPen(PEN_STYLE);
 
+    markers = new QScatterSeries(this);
+    markers->setPen(MARKER_STYLE);
+    markers->setBrush(Qt::NoBrush);
+    markers->setMarkerSize(8);
+    connect(markers, &QScatterSeries::hovered, this, &GPUChart::markerHovered);
+
     // Chart
     chart = std::make_unique<QChart>();
     chart->addSeries(series);
+    chart->addSeries(markers);
     chart->legend()->hide();
     chart->setTitle(title);
     chart->setTitleFont(TITLE_FONT);
@@ -35,7 +46,7 @@ GPUChart::GPUChart(QString title, int axisYSize, QWidget* parent) : QChartView(p
     chart->setBackgroundRoundness(0);
 
     // Axis
-    QValueAxis* axisX = new QValueAxis(chart.get());
+    axisX = new QValueAxis(chart.get());
     QValueAxis* axisY = new QValueAxis(chart.get());
     axisX->setRange(0, CHART_SIZE + (CHART_SIZE / 10));
     axisX->setLabelsVisible(false);
@@ -44,22 +55,127 @@ GPUChart::GPUChart(QString title, int axisYSize, QWidget* parent) : QChartView(p
     axisY->setLabelFormat("%.0f");
     chart->setAxisX(axisX, series);
     chart->setAxisY(axisY, series);
+    chart->setAxisX(axisX, markers);
+    chart->setAxisY(axisY, markers);
 
     currVal = new QGraphicsSimpleTextItem(chart.get());
     currVal->setFont(LABELS_FONT);
 
+    // Rolling statistics, the visible window is shown by default
+    for (int window : STATS_WINDOWS) {
+        if (window == CHART_SIZE)
+            statsWindow = stats.size();
+        stats.emplace_back(static_cast<qint64>(window) * 1000000, axisYSize);
+    }
+    statsText = new QGraphicsSimpleTextItem(chart.get());
+    statsText->setFont(LABELS_FONT);
+    statsText->setBrush(Qt::darkGray);
+
     setRenderHint(QPainter::Antialiasing);
     setChart(chart.get());
 }
 
-void GPUChart::addValue(int value) {
-    series->append(lastPosX++, value);
-    if (series->count() == CHART_SIZE) {
-        series->remove(0);
-        chart->scroll(chart->plotArea().width() / (CHART_SIZE + (CHART_SIZE / 10)), 0);
+void GPUChart::addValue(qint64 timestamp, int value) {
+    if (startTime < 0)
+        startTime = timestamp;
+    qreal x = (timestamp - startTime) / 1e6;
+    series->append(x, value);
+
+    // Drop values and markers that scrolled out of the chart
+    qreal left = x - CHART_SIZE;
+    if (left > 0) {
+        while (series->at(0).x() < left)
+            series->remove(0);
+        while (markers->count() > 0 && markers->at(0).x() < left) {
+            markerLabels.remove(markers->at(0).x());
+            markers->remove(0);
+        }
+        axisX->setRange(left, x + (CHART_SIZE / 10));
     }
 
     QPointF lastPos = chart->mapToPosition(series->at(series->count()-1));
     currVal->setPos(lastPos.x() + 5, lastPos.y() - 10);
     currVal->setText(QString::number(value));
+
+    for (RollingStats& windowStats : stats)
+        windowStats.add(timestamp, value);
+    updateStatsText();
+}
+
+void GPUChart::setStatsWindow(int window) {
+    for (size_t i = 0; i < stats.size(); i++) {
+        if (stats[i].getWindow() == static_cast<qint64>(window) * 1000000)
+            statsWindow = i;
+    }
+    updateStatsText();
+}
+
+void GPUChart::freezeStats() {
+    snapshot = stats[statsWindow].summary();
+    hasSnapshot = true;
+    updateStatsText();
+}
+
+void GPUChart::clearSnapshot() {
+    hasSnapshot = false;
+    updateStatsText();
+}
+
+void GPUChart::updateStatsText() {
+    QString text = formatStats(stats[statsWindow].summary());
+    if (hasSnapshot)
+        text += "\nSnapshot " + formatStats(snapshot);
+    statsText->setText(text);
+    statsText->setPos(chart->plotArea().topLeft() + QPointF(5, 2));
+}
+
+QString GPUChart::formatStats(const StatsSummary& summary) {
+    return QString("%1 min: min %2  max %3  avg %4  p95 %5  p99 %6")
+            .arg(summary.window / 60000000)
+            .arg(summary.min)
+            .arg(summary.max)
+            .arg(summary.mean, 0, 'f', 1)
+            .arg(summary.p95)
+            .arg(summary.p99);
+}
+
+void GPUChart::contextMenuEvent(QContextMenuEvent* event) {
+    QMenu menu(this);
+    for (size_t i = 0; i < stats.size(); i++) {
+        int window = static_cast<int>(stats[i].getWindow() / 1000000);
+        QAction* action = menu.addAction(QString("Statistics over %1 min").arg(window / 60));
+        action->setCheckable(true);
+        action->setChecked(static_cast<int>(i) == statsWindow);
+        connect(action, &QAction::triggered, this, [this, window]() { setStatsWindow(window); });
+    }
+    menu.addSeparator();
+    connect(menu.addAction("Freeze snapshot"), &QAction::triggered, this, &GPUChart::freezeStats);
+    QAction* clear = menu.addAction("Clear snapshot");
+    clear->setEnabled(hasSnapshot);
+    connect(clear, &QAction::triggered, this, &GPUChart::clearSnapshot);
+    menu.exec(event->globalPos());
+}
+
+void GPUChart::addMarker(qint64 timestamp, const QString& label) {
+    if (series->count() == 0)
+        return;
+
+    // Find the last value at or before the timestamp, markers are usually for recent values
+    qreal x = (timestamp - startTime) / 1e6;
+    int i = series->count() - 1;
+    while (i > 0 && series->at(i).x() > x)
+        i--;
+    if (series->at(i).x() > x)
+        return;
+
+    QPointF point(x, series->at(i).y());
+    markers->append(point);
+    markerLabels[point.x()] = label;
+}
+
+void GPUChart::markerHovered(const QPointF& point, bool state) {
+    if (state)
+        QToolTip::showText(QCursor::pos(), markerLabels.value(point.x()), this);
+    else
+        QToolTip::hideText();
 }
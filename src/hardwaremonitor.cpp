@@ -1,6 +1,6 @@
 #include "include/hardwaremonitor.h"
 
-HardwareMonitor::HardwareMonitor(NvidiaControl& nvidia, int gpuId, QWidget *parent) : QWidget(parent), nvidia(nvidia), gpuId(gpuId) {
+HardwareMonitor::HardwareMonitor(int gpuId, QWidget *parent) : QWidget(parent), gpuId(gpuId) {
     ui = std::make_unique<Ui::HardwareMonitor>();
     ui->setupUi(this);
 
@@ -8,61 +8,49 @@ HardwareMonitor::HardwareMonitor(NvidiaControl& nvidia, int gpuId, QWidget *pare
     chartsLayout->setSpacing(0);
     chartsLayout->setMargin(0);
     chartsLayout->setContentsMargins(0,0,0,0);
+}
 
-    updater = new QTimer(this);
-    connect(updater, &QTimer::timeout, this, &HardwareMonitor::updateCharts);
+void HardwareMonitor::setTitle(const QString& title) {
+    ui->label->setText(title);
 }
 
-void HardwareMonitor::addChart(CHARTS chart) {
+void HardwareMonitor::addChart(int metric, int maxValue) {
     // Check if chart already added
-    if (charts.contains(chart))
+    if (charts[metric] != nullptr)
         return;
 
-    switch (chart) {
-    case GPU_TEMP:
-        charts[GPU_TEMP] = new GPUChart(u8"GPU Temperature (\u2103)", 100, this);
-        break;
-    case CORE_CLOCK:
-        charts[CORE_CLOCK] = new GPUChart("Core Clock (MHz)", 3000, this);
-        break;
-    case MEM_CLOCK:
-        charts[MEM_CLOCK] = new GPUChart("Memory Clock (MHz)", 6000, this);
-        break;
-    case FAN_SPEED:
-        charts[FAN_SPEED] = new GPUChart("Fan Speed (%)", 100, this);
-        break;
-    default:
-        return;
-    }
+    const MetricDescriptor& descriptor = METRICS[metric];
+    QString title = QString("%1 (%2)").arg(descriptor.title).arg(QString::fromUtf8(descriptor.unit));
+    charts[metric] = new GPUChart(title, maxValue, this);
+    chartsLayout->addWidget(charts[metric]);
+    chartCount++;
 
-    chartsLayout->addWidget(charts[chart]);
+    ui->scrollAreaWidget->setMinimumHeight(charts[metric]->maximumHeight() * chartCount);
+}
 
-    if (charts.size() == 1)
-        updater->start(1000);
+void HardwareMonitor::updateCharts(const GPUSample& sample) {
+    if (sample.gpuId != gpuId)
+        return;
 
-    ui->scrollAreaWidget->setMinimumHeight(charts[chart]->maximumHeight() * charts.size());
+    // Update charts
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        if (charts[i] != nullptr)
+            charts[i]->addValue(sample.timestamp, sample.*METRICS[i].field);
+    }
 }
 
-void HardwareMonitor::updateCharts() {
-    ClockFreqs freqs = nvidia.getCurrentClocks(gpuId);
-    CoolerInfo cooler = nvidia.getCoolerInfo(gpuId);
-    int coreTemp = nvidia.getCoreTemp(gpuId);
+void HardwareMonitor::addThrottleEvent(const ThrottleEvent& event) {
+    if (event.gpuId != gpuId)
+        return;
 
-    // Update charts
-    for (auto it = charts.cbegin(); it != charts.cend(); ++it) {
-        switch (it.key()) {
-        case GPU_TEMP:
-            it.value()->addValue(coreTemp);
-            break;
-        case CORE_CLOCK:
-            it.value()->addValue(freqs.coreClock);
-            break;
-        case MEM_CLOCK:
-            it.value()->addValue(freqs.memClock);
-            break;
-        case FAN_SPEED:
-            it.value()->addValue(cooler.currentLevel);
-            break;
-        }
+    QString label = QString(u8"%1 throttling at %2\nCore clock %3 MHz (sustained %4 MHz), %5 \u2103")
+            .arg(ThrottleEvent::causeName(event.cause))
+            .arg(event.start.toString("hh:mm:ss"))
+            .arg(event.minClock)
+            .arg(event.peakClock)
+            .arg(event.maxTemp);
+    for (GPUChart* chart : charts) {
+        if (chart != nullptr)
+            chart->addMarker(event.timestamp, label);
     }
 }
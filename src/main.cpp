@@ -1,12 +1,168 @@
+#include <QCommandLineParser>
+#include <QSysInfo>
+#include <QProcess>
+#include <QTextStream>
+#include <QTemporaryDir>
+#include <stdexcept>
+#include <memory>
 #include "include/panel.h"
 #include "include/nvidiacontrol.h"
 #include "include/settings.h"
+#include "include/samplecache.h"
+#include "include/sampler.h"
+#include "include/controlserver.h"
+#include "include/profileswitcher.h"
+#include "include/throttledetector.h"
+#include "include/simulatednvtransport.h"
+#include "include/telemetrycollector.h"
+#include "include/telemetryaggregator.h"
+#include "include/aggregatorview.h"
+#include "include/ruleengine.h"
+#include "include/profilecomparison.h"
+#include "include/samplehistory.h"
+#include "include/trayicon.h"
+
+// Shows the charts of all hosts that stream telemetry to the given port
+static int runAggregator(QApplication& app, quint16 port) {
+    TelemetryAggregator aggregator;
+    if (!aggregator.listen(port))
+        throw std::runtime_error(QString("Failed to listen on port %1").arg(port).toStdString());
+
+    AggregatorView view(aggregator);
+    view.show();
+    return app.exec();
+}
+
+// Alternates the profiles while the workload runs, then prints how they compare
+static int runComparison(QApplication& app, NvidiaControl& nvidia, Settings& settings, int gpuId, const QStringList& names,
+                         const QString& workload, int phaseSeconds, int warmupSeconds, int rounds) {
+    if (gpuId < 0 || gpuId >= nvidia.getGpus().size())
+        throw std::runtime_error(QString("No GPU %1").arg(gpuId).toStdString());
+    if (names.size() < 2)
+        throw std::runtime_error("At least two profiles are needed for a comparison");
+    if (rounds < 1 || warmupSeconds < 0 || warmupSeconds >= phaseSeconds)
+        throw std::runtime_error("Needs at least one round, and a warm-up shorter than a phase");
+
+    const QString& gpuUUID = nvidia.getGpu(gpuId).UUID;
+    const auto& gpuProfiles = settings.getGPUProfiles(gpuUUID);
+    QVector<GPUProfile> profiles;
+    for (const QString& name : names) {
+        if (!gpuProfiles.contains(name))
+            throw std::runtime_error(QString("No profile named %1").arg(name).toStdString());
+        profiles.append(gpuProfiles.value(name));
+    }
+
+    ProfileComparison comparison(nvidia, gpuId, names, profiles, phaseSeconds * 1000 / Sampler::SAMPLE_INTERVAL,
+                                 warmupSeconds * 1000 / Sampler::SAMPLE_INTERVAL, rounds);
+    SampleCache cache;
+    Sampler sampler(nvidia, cache);
+    QObject::connect(&sampler, &Sampler::sampled, &comparison, &ProfileComparison::addSample);
+    QObject::connect(&comparison, &ProfileComparison::phaseStarted, [](int phase, const QString& name) {
+        qInfo() << "Phase" << phase + 1 << name;
+    });
+    QObject::connect(&comparison, &ProfileComparison::finished, &app, &QApplication::quit);
+    QObject::connect(&comparison, &ProfileComparison::failed, &app, &QApplication::quit);
+
+    QProcess process;
+    QString workloadError;
+    if (!workload.isEmpty()) {
+        process.setProcessChannelMode(QProcess::ForwardedChannels);
+        QObject::connect(&process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), &app, &QApplication::quit);
+        QObject::connect(&process, &QProcess::errorOccurred, [&](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart && error != QProcess::Crashed)
+                return;
+            workloadError = process.errorString();
+            app.quit();
+        });
+        process.start("/bin/sh", { "-c", workload });
+    }
+    comparison.start();
+    // Nothing to wait for if the first profile or the workload already failed
+    if (comparison.getError().isEmpty() && workloadError.isEmpty()) {
+        sampler.start();
+        app.exec();
+        sampler.stop();
+    }
+
+    if (process.state() != QProcess::NotRunning) {
+        process.terminate();
+        if (!process.waitForFinished(5000))
+            process.kill();
+    }
+
+    // Leave the GPU as it was configured at start
+    QString startProfile = settings.getApplyOnStart(gpuUUID);
+    try {
+        nvidia.applyProfile(gpuId, startProfile.isEmpty() ? GPUProfile() : settings.getProfile(gpuUUID, startProfile));
+    } catch (NvException& e) {
+        qWarning() << "Could not restore the start profile:" << e.what();
+    }
+
+    QTextStream(stdout) << comparison.report();
+    if (!comparison.getError().isEmpty()) {
+        qWarning() << comparison.getError();
+        return 1;
+    }
+    if (!workloadError.isEmpty()) {
+        qWarning() << "The workload failed:" << workloadError;
+        return 1;
+    }
+    if (!comparison.isFinished()) {
+        qWarning() << "The workload exited before the comparison finished";
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption simulateOption("simulate", "Use <count> simulated GPUs instead of the NVIDIA driver.", "count");
+    QCommandLineOption collectorOption("collector", "Stream telemetry to the aggregator at <host:port>.", "host:port");
+    QCommandLineOption nameOption("name", "Host name reported to the aggregator.", "name", QSysInfo::machineHostName());
+    QCommandLineOption aggregateOption("aggregate", "Run as aggregator, receiving telemetry on <port>.", "port");
+    QCommandLineOption headlessOption("headless", "Do not open the window.");
+    QCommandLineOption trayOption("tray", "Start in the system tray, the window is only created while it is open.");
+    QCommandLineOption compareOption("compare", "Compare the comma separated <profiles>, alternating between them.", "profiles");
+    QCommandLineOption workloadOption("workload", "Command to run while comparing profiles.", "command");
+    QCommandLineOption gpuOption("gpu", "GPU to compare profiles on.", "id", "0");
+    QCommandLineOption phaseOption("phase", "Seconds each profile runs per round.", "seconds", "60");
+    QCommandLineOption warmupOption("warmup", "Seconds discarded at the start of each phase.", "seconds", "10");
+    QCommandLineOption roundsOption("rounds", "Number of times each profile runs.", "count", "3");
+    parser.addOptions({ simulateOption, collectorOption, nameOption, aggregateOption, headlessOption, trayOption,
+                        compareOption, workloadOption, gpuOption, phaseOption, warmupOption, roundsOption });
+    parser.process(app);
+
     try {
-        NvidiaControl nvidia;
-        Settings settings;
+        if (parser.isSet(aggregateOption))
+            return runAggregator(app, parser.value(aggregateOption).toUShort());
+
+        // Simulated GPUs are named after this process, so several instances can run on one machine
+        NvidiaControl nvidia(parser.isSet(simulateOption) ?
+                                 new SimulatedNvTransport(parser.value(simulateOption).toInt(), QString("sim%1").arg(app.applicationPid())) :
+                                 nullptr);
+
+        // Simulated runs start from a copy of the configuration, so they never change the real one
+        std::unique_ptr<QTemporaryDir> simulatedConfig;
+        QString configFile = Settings::defaultFileName();
+        if (parser.isSet(simulateOption)) {
+            simulatedConfig = std::make_unique<QTemporaryDir>();
+            if (!simulatedConfig->isValid())
+                throw std::runtime_error("Cannot create a temporary directory for the simulated configuration");
+            QString copy = simulatedConfig->filePath("nvOverdrive.config");
+            if (QFile::copy(configFile, copy))
+                QFile::setPermissions(copy, QFile::ReadOwner | QFile::WriteOwner);
+            configFile = copy;
+        }
+        Settings settings(configFile);
+
+        if (parser.isSet(compareOption)) {
+            return runComparison(app, nvidia, settings, parser.value(gpuOption).toInt(), parser.value(compareOption).split(','),
+                                 parser.value(workloadOption), parser.value(phaseOption).toInt(),
+                                 parser.value(warmupOption).toInt(), parser.value(roundsOption).toInt());
+        }
 
         // Check for profiles to apply at start
         const auto& gpus = nvidia.getGpus();
@@ -17,15 +173,52 @@ int main(int argc, char *argv[]) {
 
             // Apply the profile
             qDebug() << "Applying profile " << profileName;
-            const GPUProfile& profile = settings.getProfile(gpu.UUID, profileName);
+            nvidia.applyProfile(gpu.id, settings.getProfile(gpu.UUID, profileName));
+        }
+
+        // Switch profiles when matching processes start, only if there are rules
+        ProfileSwitcher switcher(nvidia, settings);
+        if (!settings.getProcessRules().isEmpty())
+            switcher.start();
+
+        SampleCache cache;
+        Sampler sampler(nvidia, cache);
+        ControlServer controlServer(nvidia, settings, cache);
+        QObject::connect(&sampler, &Sampler::updated, &controlServer, &ControlServer::publish);
+        ThrottleTimeline throttleTimeline(nvidia, sampler);
+        SampleHistory history(nvidia.getGpus().size());
+        QObject::connect(&sampler, &Sampler::sampled, [&history](const GPUSample& sample) { history.add(sample); });
+        RuleEngine ruleEngine(nvidia, settings);
+        QObject::connect(&sampler, &Sampler::sampled, &ruleEngine, &RuleEngine::evaluate);
+        QObject::connect(&ruleEngine, &RuleEngine::notification, [](const QString& message) { qInfo() << message; });
+
+        std::unique_ptr<TelemetryCollector> collector;
+        if (parser.isSet(collectorOption)) {
+            QString aggregator = parser.value(collectorOption);
+            collector = std::make_unique<TelemetryCollector>(nvidia, sampler, parser.value(nameOption),
+                                                             aggregator.section(':', 0, -2), aggregator.section(':', -1).toUShort());
+            collector->start();
+        }
+        sampler.start();
+
+        if (parser.isSet(headlessOption))
+            return app.exec();
 
-            nvidia.setClocks(gpu.id, profile.coreClock, profile.memClock);
-            profile.manualFanControl ?
-                nvidia.setManualFanSpeed(gpu.id, profile.fanSpeed) :
-                nvidia.setFanSpeedAuto(gpu.id);
+        // The collector keeps streaming at the full rate while the window is closed
+        if (parser.isSet(trayOption)) {
+            app.setQuitOnLastWindowClosed(false);
+            TrayIcon tray(nvidia, settings, sampler, throttleTimeline, history,
+                          collector ? Sampler::SAMPLE_INTERVAL : TrayIcon::HIDDEN_INTERVAL);
+            QObject::connect(&ruleEngine, &RuleEngine::notification, &tray, &TrayIcon::showNotification);
+            tray.show();
+            return app.exec();
         }
 
-        Panel panel(nvidia, settings);
+        Panel panel(nvidia, settings, sampler, throttleTimeline, history);
+        QObject::connect(&ruleEngine, &RuleEngine::notification, &panel, [&panel](const QString& message) {
+            panel.statusBar()->showMessage(message);
+            QApplication::alert(&panel);
+        });
         panel.show();
         return app.exec();
     } catch (std::exception &e) {
@@ -0,0 +1,20 @@
+#include "include/metrics.h"
+#include <QStringList>
+
+// The driver reports utilization as "graphics=N, memory=N, ..."
+int Metrics::graphicsUtilization(const QString& value) {
+    for (const QString& entry : value.split(',')) {
+        QStringList keyVal = entry.trimmed().split('=');
+        if (keyVal.size() == 2 && keyVal[0] == "graphics")
+            return keyVal[1].toInt();
+    }
+    return 0;
+}
+
+int metricIndex(const QString& name) {
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        if (name == METRICS[i].name)
+            return i;
+    }
+    return -1;
+}
@@ -1,40 +1,12 @@
 #include "include/nvidiacontrol.h"
 
-QString NvidiaControl::xLibErr;
-
-int NvidiaControl::xLibErrorHandler(Display* d, XErrorEvent* e) {
-    char buffer[BUFSIZ];
-    XGetErrorText(d, e->error_code, buffer, BUFSIZ);
-    xLibErr = QString::fromUtf8(buffer);
-    return 0;
-}
-
-QString NvidiaControl::getXlibErr() {
-    if (!xLibErr.isNull()) {
-        QString err = xLibErr;
-        xLibErr = QString();
-        return err;
-    }
-    return xLibErr;
-}
-
-NvidiaControl::NvidiaControl() {
-    // Open X11 display
-    dpy = XOpenDisplay(nullptr);
-    if (dpy == nullptr)
-        throw NvException("Failed to open X display, check if $DISPLAY is set");
-
-    // Set error handler
-    XSetErrorHandler(&xLibErrorHandler);
-
-    // Check if XNVCtrl extension exists
-    if (!XNVCTRLQueryExtension(dpy, &eventBase, &errorBase))
-        throw NvException("NV-CONTROL X extension does not exist on " + QString(XDisplayName(nullptr)));
+NvidiaControl::NvidiaControl(NvTransport* transport) {
+    if (transport == nullptr)
+        transport = new XNvTransport();
+    this->transport.reset(transport);
 
     // Get number of GPUs in the system
-    int gpuCount = 0;
-    if (!XNVCTRLQueryTargetCount(dpy, NV_CTRL_TARGET_TYPE_GPU, &gpuCount))
-        throw NvException("Failed to query number of GPUs in the system");
+    int gpuCount = transport->queryTargetCount(NV_CTRL_TARGET_TYPE_GPU);
 
     for (int i = 0; i < gpuCount; i++) {
         // Read gpu
@@ -44,6 +16,7 @@ NvidiaControl::NvidiaControl() {
         newGpu.vBiosVer = queryStringAttribute(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_VBIOS_VERSION);
         newGpu.driverVer = queryStringAttribute(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_NVIDIA_DRIVER_VERSION);
         newGpu.UUID = queryStringAttribute(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UUID);
+        newGpu.coolers = queryCoolers(i);
         gpus.append(newGpu);
     }
 
@@ -51,11 +24,6 @@ NvidiaControl::NvidiaControl() {
         throw NvException("No NVIDIA GPUs found");
 }
 
-NvidiaControl::~NvidiaControl() {
-    if (dpy != nullptr)
-        XCloseDisplay(dpy);
-}
-
 const QVector<GPU>& NvidiaControl::getGpus() {
     return gpus;
 }
@@ -93,72 +61,211 @@ int NvidiaControl::getCoreTemp(int gpuId) {
     return queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CORE_TEMPERATURE);
 }
 
+// Temperature at which the GPU starts to slow down to protect itself
+int NvidiaControl::getSlowdownTemp(int gpuId) {
+    return queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CORE_THRESHOLD);
+}
+
+// Graphics engine utilization in percent
+int NvidiaControl::getUtilization(int gpuId) {
+    return Metrics::graphicsUtilization(queryStringAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UTILIZATION));
+}
+
 ClockFreqs NvidiaControl::getCurrentClocks(int gpuId) {
     int packedClocks = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CURRENT_CLOCK_FREQS);
 
     ClockFreqs freqs;
-    freqs.coreClock = (packedClocks >> 16) & 0xFFFF;
-    freqs.memClock = packedClocks & 0xFFFF;
+    freqs.coreClock = Metrics::highWord(packedClocks);
+    freqs.memClock = Metrics::lowWord(packedClocks);
     return freqs;
 }
 
+// Info of the first fan of the GPU
 CoolerInfo NvidiaControl::getCoolerInfo(int gpuId) {
-    CoolerInfo info;
-    info.isManual = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL);
-    info.targetLevel = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL);
-    info.currentLevel = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL);
-    return info;
+    return getCoolers(gpuId).value(0);
+}
+
+QVector<CoolerInfo> NvidiaControl::getCoolers(int gpuId) {
+    bool isManual = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL);
+    QVector<int> targetLevels = queryCoolerAttribute(gpuId, NV_CTRL_THERMAL_COOLER_LEVEL);
+    QVector<int> currentLevels = queryCoolerAttribute(gpuId, NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL);
+
+    QVector<CoolerInfo> coolers;
+    for (int i = 0; i < targetLevels.size(); i++) {
+        CoolerInfo info;
+        info.isManual = isManual;
+        info.targetLevel = targetLevels[i];
+        info.currentLevel = currentLevels[i];
+        coolers.append(info);
+    }
+    return coolers;
 }
 
 void NvidiaControl::setManualFanSpeed(int gpuId, int speed) {
+    setManualFanSpeeds(gpuId, QVector<int>(getGpu(gpuId).coolers.size(), speed));
+}
+
+// Sets the level of each fan, if there are fewer speeds than fans the last speed is used for the rest
+void NvidiaControl::setManualFanSpeeds(int gpuId, const QVector<int>& speeds) {
+    if (speeds.isEmpty())
+        return;
+
     // Set manual control if needed
     if (queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL) == NV_CTRL_GPU_COOLER_MANUAL_CONTROL_FALSE) {
         setAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL, NV_CTRL_GPU_COOLER_MANUAL_CONTROL_TRUE);
     }
-    setAttribute(gpuId, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL, speed);
+
+    QVector<int> levels;
+    for (int i = 0; i < getGpu(gpuId).coolers.size(); i++)
+        levels.append(speeds.value(i, speeds.last()));
+    setCoolerLevels(gpuId, levels);
 }
 
 void NvidiaControl::setFanSpeedAuto(int gpuId) {
     setAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL, NV_CTRL_GPU_COOLER_MANUAL_CONTROL_FALSE);
 }
 
-QString NvidiaControl::queryStringAttribute(int gpuID, int targetType, unsigned int nvAttribute) {
-    char* str;
-    bool ok = XNVCTRLQueryTargetStringAttribute(dpy, targetType, gpuID, 0, nvAttribute, &str);
-    QString xlib = getXlibErr();
-    if (!xlib.isNull() || !ok) {
-        XFree(str);
-        throw NvException(QString("queryStringAttribute %1 xlib: %2").arg(nvAttribute).arg(xlib));
+void NvidiaControl::applyProfile(int gpuId, const GPUProfile& profile) {
+    setClocks(gpuId, profile.coreClock, profile.memClock);
+    if (!profile.manualFanControl)
+        setFanSpeedAuto(gpuId);
+    else if (!profile.fanSpeeds.isEmpty())
+        setManualFanSpeeds(gpuId, profile.fanSpeeds);
+    else
+        setManualFanSpeed(gpuId, profile.fanSpeed);
+}
+
+// Reads every metric in the table while holding the lock once
+GPUSample NvidiaControl::getSample(int gpuId) {
+    GPUSample sample = {};
+    sample.gpuId = gpuId;
+
+    QMutexLocker locker(&transportLock);
+    unsigned int lastAttribute = 0;
+    int lastValue = 0;
+    bool hasLast = false;
+    for (const MetricDescriptor& metric : METRICS) {
+        switch (metric.source) {
+        case GPU_ATTRIBUTE:
+            // Metrics packed into the same attribute share one read
+            if (!hasLast || metric.nvAttribute != lastAttribute) {
+                lastValue = transport->queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, metric.nvAttribute);
+                lastAttribute = metric.nvAttribute;
+                hasLast = true;
+            }
+            sample.*metric.field = metric.unpack(lastValue);
+            break;
+        case COOLER_ATTRIBUTE:
+            for (int cooler : gpus.at(gpuId).coolers) {
+                int value = metric.unpack(transport->queryAttribute(cooler, NV_CTRL_TARGET_TYPE_COOLER, metric.nvAttribute));
+                sample.*metric.field = qMax(sample.*metric.field, value);
+            }
+            break;
+        case GPU_STRING:
+            sample.*metric.field = metric.parse(transport->queryStringAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, metric.nvAttribute));
+            break;
+        }
     }
-    QString returnStr = QString::fromUtf8(str);
-    XFree(str);
-    return returnStr;
+    return sample;
 }
 
-int NvidiaControl::queryAttribute(int gpuID, int targetType, unsigned int nvAttribute) {
-    int res;
-    bool ok = XNVCTRLQueryTargetAttribute(dpy, targetType, gpuID, 0, nvAttribute, &res);
-    QString xlib = getXlibErr();
-    if (!xlib.isNull() || !ok) {
-        throw NvException(QString("queryAttribute %1 xlib: %2").arg(nvAttribute).arg(xlib));
+// Highest value a metric can reach on this GPU, used as the upper bound of its chart
+int NvidiaControl::getMetricRange(int gpuId, const MetricDescriptor& metric) {
+    int range = 0;
+    try {
+        switch (metric.range) {
+        case FIXED_RANGE:
+            break;
+        case CORE_THRESHOLD_RANGE:
+            range = queryAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_MAX_CORE_THRESHOLD);
+            break;
+        case CORE_CLOCK_RANGE:
+            range = queryHighestPerformanceClock(gpuId, "nvclockmax");
+            if (range > 0)
+                range += qMax(0, queryValidAttributes(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS).u.range.max);
+            break;
+        case MEM_CLOCK_RANGE:
+            // The offset is of the transfer rate, which is twice the memory clock
+            range = queryHighestPerformanceClock(gpuId, "memclockmax");
+            if (range > 0)
+                range += qMax(0, queryValidAttributes(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_MEM_TRANSFER_RATE_OFFSET_ALL_PERFORMANCE_LEVELS).u.range.max) / 2;
+            break;
+        }
+    } catch (NvException&) {
+        range = 0;
     }
-    return res;
+    return range > 0 ? range : metric.fixedMax;
 }
 
-NVCTRLAttributeValidValuesRec NvidiaControl::queryValidAttributes(int gpuID, int targetType, unsigned int nvAttribute) {
-    NVCTRLAttributeValidValuesRec validAttrs;
-    bool ok = XNVCTRLQueryValidTargetAttributeValues(dpy, targetType, gpuID, 0, nvAttribute, &validAttrs);
-    QString xlib = getXlibErr();
-    if (!xlib.isNull() || !ok) {
-        throw NvException(QString("queryValidAttributes %1 xlib: %2").arg(nvAttribute).arg(xlib));
+// The driver reports the performance levels as "perf=0, nvclock=324, nvclockmax=705, ...; perf=1, ..."
+int NvidiaControl::queryHighestPerformanceClock(int gpuId, const QString& key) {
+    QString modes = queryStringAttribute(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_PERFORMANCE_MODES);
+    int highest = 0;
+    for (const QString& level : modes.split(';')) {
+        for (const QString& entry : level.split(',')) {
+            QStringList keyVal = entry.trimmed().split('=');
+            if (keyVal.size() == 2 && keyVal[0] == key)
+                highest = qMax(highest, keyVal[1].toInt());
+        }
     }
-    return validAttrs;
+    return highest;
+}
+
+QString NvidiaControl::queryStringAttribute(int gpuID, int targetType, unsigned int nvAttribute) {
+    QMutexLocker locker(&transportLock);
+    return transport->queryStringAttribute(gpuID, targetType, nvAttribute);
+}
+
+int NvidiaControl::queryAttribute(int gpuID, int targetType, unsigned int nvAttribute) {
+    QMutexLocker locker(&transportLock);
+    return transport->queryAttribute(gpuID, targetType, nvAttribute);
+}
+
+NVCTRLAttributeValidValuesRec NvidiaControl::queryValidAttributes(int gpuID, int targetType, unsigned int nvAttribute) {
+    QMutexLocker locker(&transportLock);
+    return transport->queryValidAttributes(gpuID, targetType, nvAttribute);
 }
 
 void NvidiaControl::setAttribute(int gpuID, int targetType, unsigned int nvAttribute, int value) {
-    bool ok = XNVCTRLSetTargetAttributeAndGetStatus(dpy, targetType, gpuID, 0, nvAttribute, value);
-    QString xlib = getXlibErr();
-    if (!xlib.isNull() || !ok) {
-        throw NvException(QString("setAttribute %1 %2 xlib: %3").arg(nvAttribute).arg(value).arg(xlib));
+    QMutexLocker locker(&transportLock);
+    transport->setAttribute(gpuID, targetType, nvAttribute, value);
+}
+
+// Cooler targets are not indexed by GPU, the driver reports which ones belong to it
+QVector<int> NvidiaControl::queryCoolers(int gpuId) {
+    QByteArray data;
+    try {
+        QMutexLocker locker(&transportLock);
+        data = transport->queryBinaryData(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU);
+    } catch (NvException&) {
+        // Drivers without the relationship, assume the cooler has the same index as the GPU
+        return QVector<int>{ gpuId };
     }
+
+    // The data is the number of coolers followed by their ids
+    const int* ints = reinterpret_cast<const int*>(data.constData());
+    int count = data.size() / sizeof(int);
+    QVector<int> coolers;
+    for (int i = 1; i < count && i <= ints[0]; i++)
+        coolers.append(ints[i]);
+    return coolers;
+}
+
+// Reads an attribute of all fans of a GPU while holding the lock once
+QVector<int> NvidiaControl::queryCoolerAttribute(int gpuId, unsigned int nvAttribute) {
+    QMutexLocker locker(&transportLock);
+    QVector<int> values;
+    for (int cooler : gpus.at(gpuId).coolers)
+        values.append(transport->queryAttribute(cooler, NV_CTRL_TARGET_TYPE_COOLER, nvAttribute));
+    return values;
+}
+
+void NvidiaControl::setCoolerLevels(int gpuId, const QVector<int>& levels) {
+    const QVector<int>& coolers = gpus.at(gpuId).coolers;
+    QVector<NvAttributeWrite> writes;
+    for (int i = 0; i < coolers.size() && i < levels.size(); i++)
+        writes.append({ coolers[i], NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL, levels[i] });
+
+    QMutexLocker locker(&transportLock);
+    transport->setAttributes(writes);
 }
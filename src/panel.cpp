@@ -2,7 +2,8 @@
 
 #define SB_TEMP_MSG 2000
 
-Panel::Panel(NvidiaControl& nvidia, Settings& settings, QWidget* parent) : QMainWindow(parent), nvidia(nvidia), settings(settings) {
+Panel::Panel(NvidiaControl& nvidia, Settings& settings, Sampler& sampler, ThrottleTimeline& throttleTimeline, SampleHistory& history, QWidget* parent)
+    : QMainWindow(parent), nvidia(nvidia), settings(settings), sampler(sampler), throttleTimeline(throttleTimeline), history(history) {
     ui = std::make_unique<Ui::Panel>();
     ui->setupUi(this);
 
@@ -54,12 +55,16 @@ void Panel::loadGpu(int id) {
     }
 
     // Add charts
-    hwMon = new HardwareMonitor(nvidia, selectedGPU->id, this);
+    hwMon = new HardwareMonitor(selectedGPU->id, this);
     centralWidget()->layout()->addWidget(hwMon);
-    hwMon->addChart(GPU_TEMP);
-    hwMon->addChart(CORE_CLOCK);
-    hwMon->addChart(MEM_CLOCK);
-    hwMon->addChart(FAN_SPEED);
+    for (int i = 0; i < METRIC_COUNT; i++)
+        hwMon->addChart(i, nvidia.getMetricRange(selectedGPU->id, METRICS[i]));
+    for (const GPUSample& sample : history.get(selectedGPU->id))
+        hwMon->updateCharts(sample);
+    for (const ThrottleEvent& event : throttleTimeline.getEvents())
+        hwMon->addThrottleEvent(event);
+    connect(&sampler, &Sampler::sampled, hwMon, &HardwareMonitor::updateCharts);
+    connect(&throttleTimeline, &ThrottleTimeline::eventStarted, hwMon, &HardwareMonitor::addThrottleEvent);
 }
 
 void Panel::sliderValChanged(int value) {
@@ -153,13 +158,16 @@ void Panel::deleteProfile() {
 void Panel::saveProfile() {
     QString profileName = ui->cmbBoxProfile->currentText();
 
-    GPUProfile profile;
+    // Only overwrite what the panel edits, the rest of the profile is kept
+    GPUProfile profile = settings.getProfile(selectedGPU->UUID, profileName);
     profile.coreClock = ui->sliderCoreClock->value();
     profile.memClock = ui->sliderMemClock->value();
     profile.manualFanControl = !ui->radioFanAuto->isChecked();
-    profile.manualFanControl ?
-                profile.fanSpeed = ui->sliderFanSpeed->value() :
-                profile.fanSpeed = 0;
+    // A changed fan level applies to all fans again
+    if (profile.manualFanControl && ui->sliderFanSpeed->value() != profile.fanSpeed) {
+        profile.fanSpeed = ui->sliderFanSpeed->value();
+        profile.fanSpeeds.clear();
+    }
 
     settings.editProfile(selectedGPU->UUID, profile, profileName);
     statusBar()->showMessage(QString("Saved profile \"%1\"").arg(profileName), SB_TEMP_MSG);
@@ -0,0 +1,149 @@
+#include "include/processevents.h"
+
+#include <QFile>
+#include <cerrno>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+QString ProcessEventSource::readProcessName(int pid) {
+    QFile comm(QString("/proc/%1/comm").arg(pid));
+    if (!comm.open(QIODevice::ReadOnly))
+        return QString();
+    return QString::fromUtf8(comm.readLine().trimmed());
+}
+
+QSet<int> ProcessEventSource::listProcesses() {
+    QSet<int> pids;
+    DIR* dir = opendir("/proc");
+    if (dir == nullptr)
+        return pids;
+
+    // Plain readdir, this runs often enough that QDir's overhead shows up
+    while (dirent* entry = readdir(dir)) {
+        char* end;
+        long pid = strtol(entry->d_name, &end, 10);
+        if (*end == '\0' && pid > 0)
+            pids.insert(static_cast<int>(pid));
+    }
+    closedir(dir);
+    return pids;
+}
+
+void ProcessEventSource::reportChanges(QSet<int>& known) {
+    QSet<int> current = listProcesses();
+
+    for (int pid : known) {
+        if (!current.contains(pid))
+            emit processExited(pid);
+    }
+
+    for (int pid : current) {
+        if (known.contains(pid))
+            continue;
+        QString name = readProcessName(pid);
+        if (!name.isEmpty())
+            emit processStarted(pid, name);
+    }
+
+    known = current;
+}
+
+NetlinkProcessSource::~NetlinkProcessSource() {
+    if (sock != -1)
+        close(sock);
+}
+
+bool NetlinkProcessSource::start() {
+    sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+    if (sock == -1)
+        return false;
+
+    sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+
+    // Subscribe to process events
+    char buf[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+    nlmsghdr* hdr = reinterpret_cast<nlmsghdr*>(buf);
+    hdr->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+    hdr->nlmsg_type = NLMSG_DONE;
+    cn_msg* msg = static_cast<cn_msg*>(NLMSG_DATA(hdr));
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(proc_cn_mcast_op);
+    *reinterpret_cast<proc_cn_mcast_op*>(msg->data) = PROC_CN_MCAST_LISTEN;
+
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 ||
+        send(sock, buf, hdr->nlmsg_len, 0) == -1) {
+        close(sock);
+        sock = -1;
+        return false;
+    }
+
+    notifier = new QSocketNotifier(sock, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &NetlinkProcessSource::readEvents);
+
+    // Events only cover processes started from now on
+    reportChanges(known);
+    return true;
+}
+
+void NetlinkProcessSource::readEvents() {
+    alignas(nlmsghdr) char buf[4096];
+    ssize_t len;
+
+    for (;;) {
+        len = recv(sock, buf, sizeof(buf), 0);
+        if (len == -1 && errno == ENOBUFS) {
+            // The kernel dropped events, exits among them would leave profiles applied
+            reportChanges(known);
+            continue;
+        }
+        if (len <= 0)
+            break;
+
+        for (nlmsghdr* hdr = reinterpret_cast<nlmsghdr*>(buf); NLMSG_OK(hdr, len); hdr = NLMSG_NEXT(hdr, len)) {
+            if (hdr->nlmsg_type == NLMSG_ERROR || hdr->nlmsg_type == NLMSG_NOOP)
+                continue;
+
+            const cn_msg* msg = static_cast<const cn_msg*>(NLMSG_DATA(hdr));
+            const proc_event* event = reinterpret_cast<const proc_event*>(msg->data);
+
+            if (event->what == proc_event::PROC_EVENT_EXEC) {
+                int pid = event->event_data.exec.process_tgid;
+                QString name = readProcessName(pid);
+                if (!name.isEmpty()) {
+                    known.insert(pid);
+                    emit processStarted(pid, name);
+                }
+            } else if (event->what == proc_event::PROC_EVENT_EXIT) {
+                // Ignore threads exiting
+                int pid = event->event_data.exit.process_tgid;
+                if (event->event_data.exit.process_pid == pid) {
+                    known.remove(pid);
+                    emit processExited(pid);
+                }
+            }
+        }
+    }
+}
+
+ProcScanProcessSource::ProcScanProcessSource(QObject* parent) : ProcessEventSource(parent) {
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &ProcScanProcessSource::scan);
+}
+
+bool ProcScanProcessSource::start() {
+    scan();
+    timer->start(SCAN_INTERVAL);
+    return true;
+}
+
+void ProcScanProcessSource::scan() {
+    reportChanges(known);
+}
@@ -0,0 +1,247 @@
+#include "include/profilecomparison.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// Linear interpolation between the closest ranks, the values must be sorted
+static double percentile(const std::vector<int>& sorted, double q) {
+    if (sorted.empty())
+        return 0;
+    double pos = q * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(pos);
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (pos - lower) * (sorted[upper] - sorted[lower]);
+}
+
+static double mean(const std::vector<double>& values) {
+    double sum = 0;
+    for (double value : values)
+        sum += value;
+    return values.empty() ? 0 : sum / values.size();
+}
+
+static double variance(const std::vector<double>& values) {
+    if (values.size() < 2)
+        return 0;
+    double m = mean(values);
+    double sum = 0;
+    for (double value : values)
+        sum += (value - m) * (value - m);
+    return sum / (values.size() - 1);
+}
+
+// 97.5% quantile of Student's t distribution, Cornish-Fisher expansion around the normal quantile.
+// Within 1% of the exact value from 2 degrees of freedom on, below that the exact values are interpolated.
+static double tQuantile975(double df) {
+    if (df < 2)
+        return 12.706 + (qMax(df, 1.0) - 1) * (4.303 - 12.706);
+    const double z = 1.959964;
+    const double z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z, z9 = z7 * z * z;
+    double g1 = (z3 + z) / 4;
+    double g2 = (5 * z5 + 16 * z3 + 3 * z) / 96;
+    double g3 = (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / 384;
+    double g4 = (79 * z9 + 776 * z7 + 1482 * z5 - 1920 * z3 - 945 * z) / 92160;
+    return z + g1 / df + g2 / (df * df) + g3 / (df * df * df) + g4 / (df * df * df * df);
+}
+
+static std::vector<int> pooled(const QVector<const std::vector<int>*>& phases) {
+    std::vector<int> values;
+    for (const std::vector<int>* phase : phases)
+        values.insert(values.end(), phase->begin(), phase->end());
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+ProfileComparison::ProfileComparison(NvidiaControl& nvidia, int gpuId, const QStringList& profileNames, const QVector<GPUProfile>& profiles,
+                                     int phaseSamples, int warmupSamples, int rounds, QObject* parent)
+    : QObject(parent), nvidia(nvidia), gpuId(gpuId), profileNames(profileNames), profiles(profiles),
+      phaseSamples(phaseSamples), warmupSamples(warmupSamples), rounds(rounds) {
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < profiles.size(); i++) {
+            Phase phase;
+            phase.profile = round % 2 == 0 ? i : profiles.size() - 1 - i;
+            phases.append(phase);
+        }
+    }
+}
+
+void ProfileComparison::start() {
+    currentPhase = 0;
+    phaseSeen = 0;
+    error.clear();
+    if (phases.isEmpty())
+        emit finished();
+    else
+        startPhase();
+}
+
+void ProfileComparison::startPhase() {
+    const Phase& phase = phases[currentPhase];
+    try {
+        nvidia.applyProfile(gpuId, profiles[phase.profile]);
+    } catch (NvException& e) {
+        error = QString("Could not apply %1: %2").arg(profileNames.value(phase.profile), e.what());
+        emit failed(error);
+        return;
+    }
+    emit phaseStarted(currentPhase, profileNames.value(phase.profile));
+}
+
+void ProfileComparison::addSample(const GPUSample& sample) {
+    if (sample.gpuId != gpuId || isFinished() || !error.isEmpty())
+        return;
+
+    Phase& phase = phases[currentPhase];
+    if (++phaseSeen > warmupSamples) {
+        for (int i = 0; i < METRIC_COUNT; i++)
+            phase.values[i].push_back(sample.*METRICS[i].field);
+    }
+
+    if (phaseSeen == phaseSamples) {
+        currentPhase++;
+        phaseSeen = 0;
+        if (isFinished())
+            emit finished();
+        else
+            startPhase();
+    }
+}
+
+bool ProfileComparison::isFinished() const {
+    return currentPhase >= phases.size();
+}
+
+int ProfileComparison::completedPhases() const {
+    return currentPhase;
+}
+
+const QString& ProfileComparison::getError() const {
+    return error;
+}
+
+QVector<const ProfileComparison::Phase*> ProfileComparison::phasesOf(int profile) const {
+    QVector<const Phase*> result;
+    for (int i = 0; i < currentPhase && i < phases.size(); i++) {
+        if (phases[i].profile == profile)
+            result.append(&phases[i]);
+    }
+    return result;
+}
+
+QVector<QVector<MetricSummary>> ProfileComparison::summaries() const {
+    QVector<QVector<MetricSummary>> result;
+    for (int profile = 0; profile < profiles.size(); profile++) {
+        QVector<const Phase*> profilePhases = phasesOf(profile);
+        QVector<MetricSummary> metrics(METRIC_COUNT);
+        for (int metric = 0; metric < METRIC_COUNT; metric++) {
+            QVector<const std::vector<int>*> values;
+            for (const Phase* phase : profilePhases)
+                values.append(&phase->values[metric]);
+            std::vector<int> sorted = pooled(values);
+            std::vector<double> asDouble(sorted.begin(), sorted.end());
+
+            MetricSummary& summary = metrics[metric];
+            summary.count = sorted.size();
+            summary.mean = mean(asDouble);
+            summary.stddev = std::sqrt(variance(asDouble));
+            summary.p50 = percentile(sorted, 0.5);
+            summary.p95 = percentile(sorted, 0.95);
+        }
+        result.append(metrics);
+    }
+    return result;
+}
+
+QVector<QVector<MetricDifference>> ProfileComparison::differences() const {
+    QVector<QVector<MetricDifference>> result(profiles.size(), QVector<MetricDifference>(METRIC_COUNT));
+    QVector<const Phase*> basePhases = phasesOf(0);
+    std::mt19937 random(1);
+
+    for (int profile = 1; profile < profiles.size(); profile++) {
+        QVector<const Phase*> otherPhases = phasesOf(profile);
+        if (basePhases.isEmpty() || otherPhases.isEmpty())
+            continue;
+
+        for (int metric = 0; metric < METRIC_COUNT; metric++) {
+            MetricDifference& diff = result[profile][metric];
+
+            // Welch's interval on the phase means
+            std::vector<double> baseMeans, otherMeans;
+            QVector<const std::vector<int>*> baseValues, otherValues;
+            for (const Phase* phase : basePhases) {
+                baseMeans.push_back(mean(std::vector<double>(phase->values[metric].begin(), phase->values[metric].end())));
+                baseValues.append(&phase->values[metric]);
+            }
+            for (const Phase* phase : otherPhases) {
+                otherMeans.push_back(mean(std::vector<double>(phase->values[metric].begin(), phase->values[metric].end())));
+                otherValues.append(&phase->values[metric]);
+            }
+            diff.mean = mean(otherMeans) - mean(baseMeans);
+            diff.p95 = percentile(pooled(otherValues), 0.95) - percentile(pooled(baseValues), 0.95);
+
+            diff.hasInterval = baseMeans.size() >= 2 && otherMeans.size() >= 2;
+            if (!diff.hasInterval)
+                continue;
+
+            double baseTerm = variance(baseMeans) / baseMeans.size();
+            double otherTerm = variance(otherMeans) / otherMeans.size();
+            double se = std::sqrt(baseTerm + otherTerm);
+            double halfWidth = 0;
+            if (se > 0) {
+                double df = (se * se * se * se) /
+                        (baseTerm * baseTerm / (baseMeans.size() - 1) + otherTerm * otherTerm / (otherMeans.size() - 1));
+                halfWidth = tQuantile975(df) * se;
+            }
+            diff.meanLow = diff.mean - halfWidth;
+            diff.meanHigh = diff.mean + halfWidth;
+
+            // Bootstrap of the p95 difference, resampling whole phases
+            std::vector<double> bootstrap;
+            std::uniform_int_distribution<int> pickBase(0, baseValues.size() - 1);
+            std::uniform_int_distribution<int> pickOther(0, otherValues.size() - 1);
+            for (int i = 0; i < BOOTSTRAP_ITERATIONS; i++) {
+                QVector<const std::vector<int>*> baseSample, otherSample;
+                for (int j = 0; j < baseValues.size(); j++)
+                    baseSample.append(baseValues[pickBase(random)]);
+                for (int j = 0; j < otherValues.size(); j++)
+                    otherSample.append(otherValues[pickOther(random)]);
+                bootstrap.push_back(percentile(pooled(otherSample), 0.95) - percentile(pooled(baseSample), 0.95));
+            }
+            std::sort(bootstrap.begin(), bootstrap.end());
+            diff.p95Low = bootstrap[static_cast<size_t>(0.025 * (bootstrap.size() - 1))];
+            diff.p95High = bootstrap[static_cast<size_t>(0.975 * (bootstrap.size() - 1))];
+        }
+    }
+    return result;
+}
+
+QString ProfileComparison::report() const {
+    QVector<QVector<MetricSummary>> summary = summaries();
+    QVector<QVector<MetricDifference>> diffs = differences();
+
+    QString out = QString("GPU %1, %2 of %3 phases of %4 samples, the first %5 samples of each phase discarded\n")
+            .arg(gpuId).arg(completedPhases()).arg(phases.size()).arg(phaseSamples).arg(warmupSamples);
+    out += "Power draw is not available through NV-CONTROL, so performance per watt is not reported\n";
+
+    for (int metric = 0; metric < METRIC_COUNT; metric++) {
+        out += QString("\n%1 (%2)\n").arg(METRICS[metric].name).arg(QString::fromUtf8(METRICS[metric].unit));
+        for (int profile = 0; profile < profiles.size(); profile++) {
+            const MetricSummary& s = summary[profile][metric];
+            out += QString("  %1 mean %2  sd %3  p50 %4  p95 %5  n %6\n")
+                    .arg(profileNames.value(profile), -20)
+                    .arg(s.mean, 0, 'f', 1).arg(s.stddev, 0, 'f', 1)
+                    .arg(s.p50, 0, 'f', 1).arg(s.p95, 0, 'f', 1).arg(s.count);
+        }
+        for (int profile = 1; profile < profiles.size(); profile++) {
+            const MetricDifference& d = diffs[profile][metric];
+            QString line = QString("  %1 mean %2").arg(profileNames.value(profile) + " - " + profileNames.value(0), -20).arg(d.mean, 0, 'f', 1);
+            if (d.hasInterval)
+                line += QString(" [%1, %2]").arg(d.meanLow, 0, 'f', 1).arg(d.meanHigh, 0, 'f', 1);
+            line += QString("  p95 %1").arg(d.p95, 0, 'f', 1);
+            if (d.hasInterval)
+                line += QString(" [%1, %2]").arg(d.p95Low, 0, 'f', 1).arg(d.p95High, 0, 'f', 1);
+            out += line + "\n";
+        }
+    }
+    return out;
+}
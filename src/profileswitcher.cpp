@@ -0,0 +1,108 @@
+#include "include/profileswitcher.h"
+
+ProfileSwitcher::ProfileSwitcher(NvidiaControl& nvidia, Settings& settings, ProcessEventSource* source, QObject* parent)
+    : QObject(parent), nvidia(nvidia), settings(settings), source(source) {
+    reloadRules();
+}
+
+void ProfileSwitcher::start() {
+    if (source == nullptr) {
+        source = new NetlinkProcessSource(this);
+        connect(source, &ProcessEventSource::processStarted, this, &ProfileSwitcher::processStarted);
+        connect(source, &ProcessEventSource::processExited, this, &ProfileSwitcher::processExited);
+        if (source->start())
+            return;
+
+        qDebug() << "Process connector not available, falling back to scanning /proc";
+        delete source;
+        source = new ProcScanProcessSource(this);
+    }
+
+    connect(source, &ProcessEventSource::processStarted, this, &ProfileSwitcher::processStarted);
+    connect(source, &ProcessEventSource::processExited, this, &ProfileSwitcher::processExited);
+    source->start();
+}
+
+void ProfileSwitcher::reloadRules() {
+    rules.clear();
+
+    QHash<QString, int> gpuIds;
+    for (const GPU& gpu : nvidia.getGpus())
+        gpuIds[gpu.UUID] = gpu.id;
+
+    for (const ProcessRule& rule : settings.getProcessRules()) {
+        if (!gpuIds.contains(rule.gpuUUID))
+            continue;
+        // Match against the name as the kernel reports it
+        QString name = rule.executable.left(ProcessEventSource::COMM_LENGTH);
+        rules[name].append({ gpuIds[rule.gpuUUID], rule.profileName });
+    }
+}
+
+QString ProfileSwitcher::getActiveProfile(int gpuId) const {
+    const auto& stack = active.value(gpuId);
+    return stack.isEmpty() ? QString() : stack.last().second;
+}
+
+void ProfileSwitcher::processStarted(int pid, const QString& name) {
+    // A process that execs another program is reported again with the new name
+    if (running.contains(pid))
+        processExited(pid);
+
+    auto it = rules.constFind(name);
+    if (it == rules.constEnd())
+        return;
+
+    running[pid] = it.value();
+    for (const Target& target : it.value()) {
+        active[target.gpuId].append(qMakePair(pid, target.profileName));
+        applyProfile(target.gpuId, target.profileName);
+    }
+}
+
+void ProfileSwitcher::processExited(int pid) {
+    auto it = running.find(pid);
+    if (it == running.end())
+        return;
+
+    for (const Target& target : it.value()) {
+        auto& stack = active[target.gpuId];
+        bool wasActive = !stack.isEmpty() && stack.last().first == pid;
+        for (int i = stack.size() - 1; i >= 0; i--) {
+            if (stack[i].first == pid)
+                stack.remove(i);
+        }
+
+        if (!wasActive)
+            continue;
+
+        // Return to the profile of the previous matching process, or the base profile
+        if (!stack.isEmpty())
+            applyProfile(target.gpuId, stack.last().second);
+        else
+            applyProfile(target.gpuId, settings.getApplyOnStart(nvidia.getGpu(target.gpuId).UUID));
+    }
+    running.erase(it);
+}
+
+void ProfileSwitcher::applyProfile(int gpuId, const QString& profileName) {
+    const QString& gpuUUID = nvidia.getGpu(gpuId).UUID;
+
+    // An empty name means the driver defaults
+    GPUProfile profile;
+    if (!profileName.isEmpty()) {
+        const auto& profiles = settings.getGPUProfiles(gpuUUID);
+        if (!profiles.contains(profileName)) {
+            qWarning() << "Process rule refers to missing profile" << profileName;
+            return;
+        }
+        profile = profiles.value(profileName);
+    }
+
+    try {
+        nvidia.applyProfile(gpuId, profile);
+        emit profileSwitched(gpuId, profileName);
+    } catch (NvException& e) {
+        qWarning() << e.what();
+    }
+}
@@ -0,0 +1,91 @@
+#include "include/rollingstats.h"
+
+#include <algorithm>
+#include <cmath>
+
+RollingStats::RollingStats(long long window, int rangeMax, int buckets)
+    : window(window), rangeMax(std::max(rangeMax, 1)), histogram(buckets) {
+}
+
+int RollingStats::bucket(int value) const {
+    int clamped = std::min(std::max(value, 0), rangeMax);
+    return static_cast<int>(static_cast<long long>(clamped) * histogram.size() / (rangeMax + 1));
+}
+
+void RollingStats::add(long long time, int value) {
+    // Evict the values that left the window
+    long long expired = time - window;
+    while (!values.empty() && values.front().first <= expired) {
+        int old = values.front().second;
+        sum -= old;
+        histogram[bucket(old)]--;
+        values.pop_front();
+    }
+    while (!minQueue.empty() && minQueue.front().first <= expired)
+        minQueue.pop_front();
+    while (!maxQueue.empty() && maxQueue.front().first <= expired)
+        maxQueue.pop_front();
+
+    values.emplace_back(time, value);
+    sum += value;
+    histogram[bucket(value)]++;
+
+    while (!minQueue.empty() && minQueue.back().second >= value)
+        minQueue.pop_back();
+    minQueue.emplace_back(time, value);
+    while (!maxQueue.empty() && maxQueue.back().second <= value)
+        maxQueue.pop_back();
+    maxQueue.emplace_back(time, value);
+}
+
+long long RollingStats::getWindow() const {
+    return window;
+}
+
+int RollingStats::count() const {
+    return static_cast<int>(values.size());
+}
+
+int RollingStats::min() const {
+    return minQueue.empty() ? 0 : minQueue.front().second;
+}
+
+int RollingStats::max() const {
+    return maxQueue.empty() ? 0 : maxQueue.front().second;
+}
+
+double RollingStats::mean() const {
+    return count() == 0 ? 0 : static_cast<double>(sum) / count();
+}
+
+int RollingStats::quantile(double q) const {
+    int n = count();
+    if (n == 0)
+        return 0;
+
+    // Find the bucket holding the value of the wanted rank and interpolate inside it
+    int rank = std::max(1, static_cast<int>(std::ceil(q * n)));
+    int seen = 0;
+    double bucketWidth = static_cast<double>(rangeMax + 1) / histogram.size();
+    for (size_t i = 0; i < histogram.size(); i++) {
+        if (seen + histogram[i] >= rank) {
+            double pos = static_cast<double>(rank - seen) / histogram[i];
+            int value = static_cast<int>(std::lround((i + pos) * bucketWidth));
+            return std::min(std::max(value, min()), max());
+        }
+        seen += histogram[i];
+    }
+    return max();
+}
+
+StatsSummary RollingStats::summary() const {
+    StatsSummary summary;
+    summary.window = window;
+    summary.count = count();
+    summary.min = min();
+    summary.max = max();
+    summary.mean = mean();
+    summary.p95 = quantile(0.95);
+    summary.p99 = quantile(0.99);
+    return summary;
+}
@@ -0,0 +1,145 @@
+#include "include/ruleengine.h"
+
+RuleEngine::RuleEngine(NvidiaControl& nvidia, Settings& settings, QObject* parent) : QObject(parent), nvidia(nvidia), settings(settings) {
+    gpuCount = nvidia.getGpus().size();
+    compile();
+}
+
+int RuleEngine::ruleCount() const {
+    return compiled.size();
+}
+
+void RuleEngine::compile() {
+    program.clear();
+    compiled.clear();
+    rules = settings.getAlertRules();
+
+    for (int i = 0; i < rules.size(); i++) {
+        CompiledRule compiledRule;
+        compiledRule.ruleIndex = i;
+        compiledRule.first = program.size();
+        if (compileRule(rules[i], compiledRule)) {
+            compiled.append(compiledRule);
+        } else {
+            qWarning() << "Skipping invalid alert rule" << rules[i].name;
+            program.resize(compiledRule.first);
+        }
+    }
+
+    held.fill(HoldState(), compiled.size() * gpuCount);
+}
+
+bool RuleEngine::compileRule(const AlertRule& rule, CompiledRule& compiledRule) {
+    static const QMap<QString, Op> ops = {
+        { ">", GT }, { ">=", GE }, { "<", LT }, { "<=", LE }, { "==", EQ }, { "!=", NE }
+    };
+    static const QMap<QString, Action> actions = {
+        { "profile", APPLY_PROFILE }, { "fanAuto", FAN_AUTO }, { "command", RUN_COMMAND }, { "notify", NOTIFY }
+    };
+
+    if (rule.conditions.isEmpty() || !actions.contains(rule.action))
+        return false;
+    compiledRule.action = actions[rule.action];
+
+    compiledRule.gpuId = -1;
+    if (!rule.gpuUUID.isEmpty()) {
+        for (const GPU& gpu : nvidia.getGpus()) {
+            if (gpu.UUID == rule.gpuUUID)
+                compiledRule.gpuId = gpu.id;
+        }
+        if (compiledRule.gpuId == -1)
+            return false;
+    }
+
+    compiledRule.holdTime = static_cast<qint64>(qMax(0, rule.duration)) * 1000000;
+
+    for (const AlertCondition& condition : rule.conditions) {
+        int metric = metricIndex(condition.metric);
+        if (metric == -1 || !ops.contains(condition.op))
+            return false;
+        program.append({ METRICS[metric].field, ops[condition.op], condition.value });
+    }
+    compiledRule.count = program.size() - compiledRule.first;
+    return true;
+}
+
+void RuleEngine::evaluate(const GPUSample& sample) {
+    if (sample.gpuId < 0 || sample.gpuId >= gpuCount)
+        return;
+
+    const Instruction* instructions = program.constData();
+    for (int i = 0; i < compiled.size(); i++) {
+        const CompiledRule& rule = compiled[i];
+        if (rule.gpuId != -1 && rule.gpuId != sample.gpuId)
+            continue;
+
+        bool match = true;
+        const Instruction* end = instructions + rule.first + rule.count;
+        for (const Instruction* in = instructions + rule.first; match && in != end; ++in) {
+            int value = sample.*(in->field);
+            switch (in->op) {
+            case GT: match = value > in->value; break;
+            case GE: match = value >= in->value; break;
+            case LT: match = value < in->value; break;
+            case LE: match = value <= in->value; break;
+            case EQ: match = value == in->value; break;
+            case NE: match = value != in->value; break;
+            }
+        }
+
+        HoldState& state = held[i * gpuCount + sample.gpuId];
+        if (!match) {
+            state = HoldState();
+            continue;
+        }
+        if (state.since < 0)
+            state.since = sample.timestamp;
+        if (!state.fired && sample.timestamp - state.since >= rule.holdTime) {
+            state.fired = true;
+            runAction(rule, sample.gpuId);
+        }
+    }
+}
+
+void RuleEngine::runAction(const CompiledRule& rule, int gpuId) {
+    const AlertRule& alertRule = rules[rule.ruleIndex];
+    const GPU& gpu = nvidia.getGpu(gpuId);
+    emit ruleTriggered(alertRule.name, gpuId);
+
+    try {
+        switch (rule.action) {
+        case APPLY_PROFILE: {
+            const auto& profiles = settings.getGPUProfiles(gpu.UUID);
+            if (!profiles.contains(alertRule.argument)) {
+                qWarning() << "Alert rule" << alertRule.name << "refers to missing profile" << alertRule.argument;
+                return;
+            }
+            nvidia.applyProfile(gpuId, profiles.value(alertRule.argument));
+            emit notification(QString("%1: applied profile \"%2\" to GPU %3").arg(alertRule.name).arg(alertRule.argument).arg(gpuId));
+            break;
+        }
+        case FAN_AUTO:
+            nvidia.setFanSpeedAuto(gpuId);
+            emit notification(QString("%1: GPU %2 fans set to automatic").arg(alertRule.name).arg(gpuId));
+            break;
+        case RUN_COMMAND: {
+            QProcess process;
+            process.setProgram("/bin/sh");
+            process.setArguments({ "-c", alertRule.argument });
+            QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            env.insert("NVOVERDRIVE_RULE", alertRule.name);
+            env.insert("NVOVERDRIVE_GPU", QString::number(gpuId));
+            env.insert("NVOVERDRIVE_GPU_UUID", gpu.UUID);
+            process.setProcessEnvironment(env);
+            process.startDetached();
+            emit notification(QString("%1: ran command on GPU %2").arg(alertRule.name).arg(gpuId));
+            break;
+        }
+        case NOTIFY:
+            emit notification(QString("%1 on GPU %2 %3").arg(alertRule.name).arg(gpuId).arg(alertRule.argument).trimmed());
+            break;
+        }
+    } catch (NvException& e) {
+        qWarning() << e.what();
+    }
+}
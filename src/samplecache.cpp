@@ -0,0 +1,43 @@
+#include "include/samplecache.h"
+
+void SampleCache::update(const GPUSample& sample) {
+    QWriteLocker locker(&lock);
+    latest[sample.gpuId] = sample;
+    sampleCounts[sample.gpuId]++;
+    sequence++;
+}
+
+bool SampleCache::getLatest(int gpuId, GPUSample& sample) const {
+    QReadLocker locker(&lock);
+    auto it = latest.constFind(gpuId);
+    if (it == latest.constEnd())
+        return false;
+
+    sample = it.value();
+    return true;
+}
+
+quint64 SampleCache::getSampleCount(int gpuId) const {
+    QReadLocker locker(&lock);
+    return sampleCounts.value(gpuId, 0);
+}
+
+QVector<GPUSample> SampleCache::getAll() const {
+    QReadLocker locker(&lock);
+    return latest.values().toVector();
+}
+
+quint64 SampleCache::getSequence() const {
+    QReadLocker locker(&lock);
+    return sequence;
+}
+
+void SampleCache::updateTiming(const SamplerTiming& timing) {
+    QWriteLocker locker(&lock);
+    this->timing = timing;
+}
+
+SamplerTiming SampleCache::getTiming() const {
+    QReadLocker locker(&lock);
+    return timing;
+}
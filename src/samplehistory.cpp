@@ -0,0 +1,45 @@
+#include "include/samplehistory.h"
+
+SampleHistory::SampleHistory(int gpuCount) : rings(gpuCount) {
+}
+
+void SampleHistory::add(const GPUSample& sample) {
+    if (sample.gpuId < 0 || sample.gpuId >= rings.size())
+        return;
+
+    Ring& ring = rings[sample.gpuId];
+    CompactSample compact;
+    compact.gap = ring.lastTimestamp < 0 ? 0 : static_cast<quint32>((sample.timestamp - ring.lastTimestamp) / 1000);
+    for (int i = 0; i < METRIC_COUNT; i++)
+        compact.values[i] = static_cast<qint16>(qBound(-32768, sample.*METRICS[i].field, 32767));
+
+    // The timestamp is rounded like the gap, so rebuilt times do not drift
+    ring.lastTimestamp = ring.lastTimestamp < 0 ? sample.timestamp : ring.lastTimestamp + compact.gap * 1000LL;
+    if (static_cast<int>(ring.samples.size()) < HISTORY_SIZE) {
+        ring.samples.push_back(compact);
+    } else {
+        ring.samples[ring.next] = compact;
+        ring.next = (ring.next + 1) % HISTORY_SIZE;
+    }
+}
+
+QVector<GPUSample> SampleHistory::get(int gpuId) const {
+    if (gpuId < 0 || gpuId >= rings.size())
+        return QVector<GPUSample>();
+
+    // Times are rebuilt backwards from the newest sample
+    const Ring& ring = rings[gpuId];
+    int count = ring.samples.size();
+    QVector<GPUSample> result(count);
+    qint64 timestamp = ring.lastTimestamp;
+    for (int i = count - 1; i >= 0; i--) {
+        const CompactSample& compact = ring.samples[(ring.next + i) % count];
+        GPUSample& sample = result[i];
+        sample.gpuId = gpuId;
+        sample.timestamp = timestamp;
+        for (int j = 0; j < METRIC_COUNT; j++)
+            sample.*METRICS[j].field = compact.values[j];
+        timestamp -= compact.gap * 1000LL;
+    }
+    return result;
+}
@@ -0,0 +1,94 @@
+#include "include/sampler.h"
+
+Sampler::Sampler(NvidiaControl& nvidia, SampleCache& cache, QObject* parent) : QObject(parent), nvidia(nvidia), cache(cache) {
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &Sampler::tick);
+}
+
+qint64 Sampler::monotonicTime() {
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() / 1000;
+}
+
+void Sampler::start(int interval) {
+    this->interval = static_cast<qint64>(interval) * 1000;
+    timing = SamplerTiming();
+    nextDeadline = monotonicTime() + this->interval;
+    schedule();
+}
+
+void Sampler::stop() {
+    timer->stop();
+}
+
+void Sampler::setInterval(int interval) {
+    this->interval = static_cast<qint64>(interval) * 1000;
+    if (!timer->isActive())
+        return;
+    nextDeadline = qMin(nextDeadline, monotonicTime() + this->interval);
+    schedule();
+}
+
+int Sampler::getInterval() const {
+    return static_cast<int>(interval / 1000);
+}
+
+const SamplerTiming& Sampler::getTiming() const {
+    return timing;
+}
+
+void Sampler::schedule() {
+    // Rounded up, so the timer does not fire before the deadline
+    qint64 remaining = nextDeadline - monotonicTime();
+    timer->start(static_cast<int>(qMax<qint64>(0, (remaining + 999) / 1000)));
+}
+
+void Sampler::tick() {
+    qint64 now = monotonicTime();
+    if (now < nextDeadline) {
+        schedule();
+        return;
+    }
+
+    // Deadlines that passed while the event loop was blocked are skipped, the tick serves the latest one
+    int missed = static_cast<int>((now - nextDeadline) / interval);
+    nextDeadline += missed * interval;
+    if (missed > 0) {
+        timing.missedTicks += missed;
+        emit ticksMissed(missed);
+    }
+
+    // Running mean and variance of the lateness (Welford)
+    qint64 lateness = now - nextDeadline;
+    timing.ticks++;
+    timing.lastLateness = lateness;
+    timing.maxLateness = qMax(timing.maxLateness, lateness);
+    double delta = lateness - timing.meanLateness;
+    timing.meanLateness += delta / timing.ticks;
+    timing.latenessM2 += delta * (lateness - timing.meanLateness);
+
+    sampleAll();
+    cache.updateTiming(timing);
+
+    nextDeadline += interval;
+    schedule();
+}
+
+void Sampler::sampleAll() {
+    for (const GPU& gpu : nvidia.getGpus()) {
+        try {
+            qint64 readStart = monotonicTime();
+            GPUSample sample = nvidia.getSample(gpu.id);
+            qint64 readEnd = monotonicTime();
+            sample.timestamp = readStart + (readEnd - readStart) / 2;
+            timing.maxReadTime = qMax(timing.maxReadTime, readEnd - readStart);
+
+            cache.update(sample);
+            emit sampled(sample);
+        } catch (NvException& e) {
+            qWarning() << e.what();
+        }
+    }
+    emit updated();
+}
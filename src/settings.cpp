@@ -8,6 +8,20 @@
 #define MEMCLOCK "memClock"
 #define MAN_FAN_CONTROL "manualFanControl"
 #define FANSPEED "fanSpeed"
+#define FANSPEEDS "fanSpeeds"
+#define PROCESS_RULES "ProcessRules"
+#define EXECUTABLE "executable"
+#define GPU_UUID "gpu"
+#define PROFILE "profile"
+#define ALERT_RULES "AlertRules"
+#define NAME "name"
+#define CONDITIONS "conditions"
+#define METRIC "metric"
+#define OP "op"
+#define VALUE "value"
+#define DURATION "duration"
+#define ACTION "action"
+#define ARGUMENT "argument"
 
 GPUProfile::GPUProfile(int powerLimit, int coreClock, int memClock, bool manualFanControl, int fanSpeed) {
     this->powerLimit = powerLimit;
@@ -23,6 +37,8 @@ GPUProfile::GPUProfile(const QJsonObject &json) {
     memClock = json[MEMCLOCK].toInt();
     manualFanControl = json[MAN_FAN_CONTROL].toBool();
     fanSpeed = json[FANSPEED].toInt();
+    for (const QJsonValue& speed : json[FANSPEEDS].toArray())
+        fanSpeeds.append(speed.toInt());
 }
 
 QJsonObject GPUProfile::serialize() const {
@@ -32,15 +48,91 @@ QJsonObject GPUProfile::serialize() const {
     json[MEMCLOCK] = memClock;
     json[MAN_FAN_CONTROL] = manualFanControl;
     json[FANSPEED] = fanSpeed;
+    if (!fanSpeeds.isEmpty()) {
+        QJsonArray speedsArr;
+        for (int speed : fanSpeeds)
+            speedsArr.append(speed);
+        json[FANSPEEDS] = speedsArr;
+    }
     return json;
 }
 
-Settings::Settings() {
-    QString configDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
-    if (configDir.isEmpty())
-        throw SettingsException("Cannot determine a directory to save configuration to");
+ProcessRule::ProcessRule(const QString& executable, const QString& gpuUUID, const QString& profileName) {
+    this->executable = executable;
+    this->gpuUUID = gpuUUID;
+    this->profileName = profileName;
+}
+
+ProcessRule::ProcessRule(const QJsonObject& json) {
+    executable = json[EXECUTABLE].toString();
+    gpuUUID = json[GPU_UUID].toString();
+    profileName = json[PROFILE].toString();
+}
+
+QJsonObject ProcessRule::serialize() const {
+    QJsonObject json;
+    json[EXECUTABLE] = executable;
+    json[GPU_UUID] = gpuUUID;
+    json[PROFILE] = profileName;
+    return json;
+}
+
+AlertCondition::AlertCondition(const QString& metric, const QString& op, int value) {
+    this->metric = metric;
+    this->op = op;
+    this->value = value;
+}
+
+AlertCondition::AlertCondition(const QJsonObject& json) {
+    metric = json[METRIC].toString();
+    op = json[OP].toString();
+    value = json[VALUE].toInt();
+}
 
-    QString fileName = configDir + "/nvOverdrive/nvOverdrive.config";
+QJsonObject AlertCondition::serialize() const {
+    QJsonObject json;
+    json[METRIC] = metric;
+    json[OP] = op;
+    json[VALUE] = value;
+    return json;
+}
+
+AlertRule::AlertRule(const QString& name, const QString& gpuUUID, int duration, const QString& action, const QString& argument) {
+    this->name = name;
+    this->gpuUUID = gpuUUID;
+    this->duration = duration;
+    this->action = action;
+    this->argument = argument;
+}
+
+AlertRule::AlertRule(const QJsonObject& json) {
+    name = json[NAME].toString();
+    gpuUUID = json[GPU_UUID].toString();
+    for (const QJsonValue& condition : json[CONDITIONS].toArray())
+        conditions.append(AlertCondition(condition.toObject()));
+    duration = json[DURATION].toInt();
+    action = json[ACTION].toString();
+    argument = json[ARGUMENT].toString();
+}
+
+QJsonObject AlertRule::serialize() const {
+    QJsonObject json;
+    json[NAME] = name;
+    json[GPU_UUID] = gpuUUID;
+    QJsonArray conditionsArr;
+    for (const AlertCondition& condition : conditions)
+        conditionsArr.append(condition.serialize());
+    json[CONDITIONS] = conditionsArr;
+    json[DURATION] = duration;
+    json[ACTION] = action;
+    json[ARGUMENT] = argument;
+    return json;
+}
+
+Settings::Settings() : Settings(defaultFileName()) {
+}
+
+Settings::Settings(const QString& fileName) {
     configFile = std::make_unique<QFile>(fileName);
 
     // Read settings if exist
@@ -48,6 +140,13 @@ Settings::Settings() {
         readSettings();
 }
 
+QString Settings::defaultFileName() {
+    QString configDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+    if (configDir.isEmpty())
+        throw SettingsException("Cannot determine a directory to save configuration to");
+    return configDir + "/nvOverdrive/nvOverdrive.config";
+}
+
 void Settings::writeSettings() {
     if (!configFile->open(QIODevice::WriteOnly|QIODevice::Text))
         throw SettingsException("Failed to open config file in write mode");
@@ -55,6 +154,8 @@ void Settings::writeSettings() {
     QJsonObject settingsObj;
     writeAppSettings(settingsObj);
     writeProfiles(settingsObj);
+    writeProcessRules(settingsObj);
+    writeAlertRules(settingsObj);
     configFile->write(QJsonDocument(settingsObj).toJson());
     configFile->close();
 }
@@ -93,6 +194,22 @@ void Settings::writeProfiles(QJsonObject& json) {
     json[PROFILES] = profilesObj;
 }
 
+void Settings::writeProcessRules(QJsonObject& json) {
+    QJsonArray rulesArr;
+    for (const ProcessRule& rule : processRules)
+        rulesArr.append(rule.serialize());
+
+    json[PROCESS_RULES] = rulesArr;
+}
+
+void Settings::writeAlertRules(QJsonObject& json) {
+    QJsonArray rulesArr;
+    for (const AlertRule& rule : alertRules)
+        rulesArr.append(rule.serialize());
+
+    json[ALERT_RULES] = rulesArr;
+}
+
 void Settings::readSettings() {
     if (!configFile->open(QIODevice::ReadOnly|QIODevice::Text))
         throw SettingsException("Failed to open config file in read mode");
@@ -101,6 +218,8 @@ void Settings::readSettings() {
     QJsonDocument settingsDoc = QJsonDocument::fromJson(data);
     readAppSettings(settingsDoc.object());
     readProfiles(settingsDoc.object());
+    readProcessRules(settingsDoc.object());
+    readAlertRules(settingsDoc.object());
     configFile->close();
 }
 
@@ -130,6 +249,18 @@ void Settings::readProfiles(const QJsonObject& json) {
     }
 }
 
+void Settings::readProcessRules(const QJsonObject& json) {
+    QJsonArray rulesArr = json[PROCESS_RULES].toArray();
+    for (const QJsonValue& rule : rulesArr)
+        processRules.append(ProcessRule(rule.toObject()));
+}
+
+void Settings::readAlertRules(const QJsonObject& json) {
+    QJsonArray rulesArr = json[ALERT_RULES].toArray();
+    for (const QJsonValue& rule : rulesArr)
+        alertRules.append(AlertRule(rule.toObject()));
+}
+
 // If there are no profiles for a GPU, just create a temporary profile
 const QMap<QString, GPUProfile>& Settings::getGPUProfiles(const QString& gpuUUID) {
     if (!gpuProfiles.contains(gpuUUID)) {
@@ -180,3 +311,31 @@ void Settings::setApplyOnStart(const QString &gpuUUID, const QString &profileNam
 const GPUProfile& Settings::getProfile(const QString &gpuUUID, const QString &profileName) {
     return gpuProfiles[gpuUUID][profileName];
 }
+
+const QVector<ProcessRule>& Settings::getProcessRules() {
+    return processRules;
+}
+
+void Settings::addProcessRule(const ProcessRule& rule) {
+    processRules.append(rule);
+    writeSettings();
+}
+
+void Settings::removeProcessRule(int index) {
+    processRules.remove(index);
+    writeSettings();
+}
+
+const QVector<AlertRule>& Settings::getAlertRules() {
+    return alertRules;
+}
+
+void Settings::addAlertRule(const AlertRule& rule) {
+    alertRules.append(rule);
+    writeSettings();
+}
+
+void Settings::removeAlertRule(int index) {
+    alertRules.remove(index);
+    writeSettings();
+}
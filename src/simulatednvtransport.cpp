@@ -0,0 +1,98 @@
+#include "include/simulatednvtransport.h"
+
+#include <cmath>
+
+SimulatedNvTransport::SimulatedNvTransport(int gpuCount, const QString& idPrefix) : gpuCount(gpuCount), idPrefix(idPrefix) {
+    clock.start();
+}
+
+quint64 SimulatedNvTransport::key(int targetId, int targetType, unsigned int nvAttribute) {
+    return (static_cast<quint64>(targetType) << 48) | (static_cast<quint64>(targetId) << 32) | nvAttribute;
+}
+
+int SimulatedNvTransport::wave(int gpuId, int min, int max, double periodSec) {
+    double t = clock.elapsed() / 1000.0 + gpuId * 7.0;
+    double level = (std::sin(2 * M_PI * t / periodSec) + 1) / 2;
+    return min + static_cast<int>(level * (max - min));
+}
+
+int SimulatedNvTransport::coreOffset(int gpuId) {
+    return attributes.value(key(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS));
+}
+
+int SimulatedNvTransport::queryTargetCount(int targetType) {
+    if (targetType == NV_CTRL_TARGET_TYPE_GPU || targetType == NV_CTRL_TARGET_TYPE_COOLER)
+        return gpuCount;
+    return 0;
+}
+
+QString SimulatedNvTransport::queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) {
+    if (targetType != NV_CTRL_TARGET_TYPE_GPU || targetId >= gpuCount)
+        throw NvException(QString("queryStringAttribute %1").arg(nvAttribute));
+
+    switch (nvAttribute) {
+    case NV_CTRL_STRING_PRODUCT_NAME:
+        return "Simulated GPU";
+    case NV_CTRL_STRING_VBIOS_VERSION:
+        return "0.0";
+    case NV_CTRL_STRING_NVIDIA_DRIVER_VERSION:
+        return "simulated";
+    case NV_CTRL_STRING_GPU_UUID:
+        return QString("GPU-%1-%2").arg(idPrefix).arg(targetId);
+    case NV_CTRL_STRING_GPU_UTILIZATION:
+        return QString("graphics=%1, memory=%2, video=0, PCIe=0").arg(wave(targetId, 0, 100, 60)).arg(wave(targetId, 0, 40, 60));
+    case NV_CTRL_STRING_PERFORMANCE_MODES:
+        return "perf=0, nvclock=300, nvclockmin=300, nvclockmax=900, memclock=405, memclockmin=405, memclockmax=405; "
+               "perf=1, nvclock=300, nvclockmin=300, nvclockmax=1900, memclock=7000, memclockmin=7000, memclockmax=7000";
+    default:
+        throw NvException(QString("queryStringAttribute %1").arg(nvAttribute));
+    }
+}
+
+int SimulatedNvTransport::queryAttribute(int targetId, int targetType, unsigned int nvAttribute) {
+    if (targetType == NV_CTRL_TARGET_TYPE_GPU) {
+        switch (nvAttribute) {
+        case NV_CTRL_GPU_CORE_TEMPERATURE:
+            return wave(targetId, 35, 80, 120) + coreOffset(targetId) / 20;
+        case NV_CTRL_GPU_CORE_THRESHOLD:
+            return 90;
+        case NV_CTRL_GPU_MAX_CORE_THRESHOLD:
+            return 100;
+        case NV_CTRL_GPU_CURRENT_CLOCK_FREQS:
+            return ((wave(targetId, 300, 1900, 60) + coreOffset(targetId)) << 16) |
+                   (wave(targetId, 405, 7000, 60) + attributes.value(key(targetId, targetType, NV_CTRL_GPU_MEM_TRANSFER_RATE_OFFSET_ALL_PERFORMANCE_LEVELS)) / 2);
+        }
+    } else if (targetType == NV_CTRL_TARGET_TYPE_COOLER && nvAttribute == NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL) {
+        // Each GPU has one cooler with the same index
+        if (attributes.value(key(targetId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL)))
+            return attributes.value(key(targetId, targetType, NV_CTRL_THERMAL_COOLER_LEVEL));
+        return wave(targetId, 20, 70, 120);
+    }
+    return attributes.value(key(targetId, targetType, nvAttribute), 0);
+}
+
+NVCTRLAttributeValidValuesRec SimulatedNvTransport::queryValidAttributes(int, int, unsigned int) {
+    NVCTRLAttributeValidValuesRec validAttrs = {};
+    validAttrs.type = ATTRIBUTE_TYPE_RANGE;
+    validAttrs.u.range.min = -200;
+    validAttrs.u.range.max = 1000;
+    return validAttrs;
+}
+
+QByteArray SimulatedNvTransport::queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) {
+    // One fan per GPU, with the same index
+    if (targetType == NV_CTRL_TARGET_TYPE_GPU && nvAttribute == NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU) {
+        int data[] = { 1, targetId };
+        return QByteArray(reinterpret_cast<const char*>(data), sizeof(data));
+    }
+    throw NvException(QString("queryBinaryData %1").arg(nvAttribute));
+}
+
+void SimulatedNvTransport::setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) {
+    attributes[key(targetId, targetType, nvAttribute)] = value;
+}
+
+void SimulatedNvTransport::setAttributes(const QVector<NvAttributeWrite>& writes) {
+    for (const NvAttributeWrite& write : writes)
+        setAttribute(write.targetId, write.targetType, write.nvAttribute, write.value);
+}
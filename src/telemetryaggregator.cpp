@@ -0,0 +1,92 @@
+#include "include/telemetryaggregator.h"
+
+TelemetryAggregator::TelemetryAggregator(QObject* parent) : QObject(parent) {
+    server = new QTcpServer(this);
+    server->setMaxPendingConnections(MAX_CONNECTIONS);
+    connect(server, &QTcpServer::newConnection, this, &TelemetryAggregator::newConnection);
+}
+
+bool TelemetryAggregator::listen(quint16 port, const QHostAddress& address) {
+    return server->listen(address, port);
+}
+
+quint16 TelemetryAggregator::serverPort() const {
+    return server->serverPort();
+}
+
+int TelemetryAggregator::streamCount() const {
+    return streamIds.size();
+}
+
+void TelemetryAggregator::newConnection() {
+    while (QTcpSocket* socket = server->nextPendingConnection()) {
+        if (connections.size() >= MAX_CONNECTIONS) {
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        connections.insert(socket, Connection());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readConnection(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { dropConnection(socket); });
+    }
+}
+
+// Frees the decoder and the stream table of the connection along with the socket
+void TelemetryAggregator::dropConnection(QTcpSocket* socket) {
+    if (connections.remove(socket))
+        socket->deleteLater();
+}
+
+void TelemetryAggregator::readConnection(QTcpSocket* socket) {
+    auto it = connections.find(socket);
+    if (it == connections.end())
+        return;
+
+    QVector<TelemetryFrame> frames;
+    bool ok = it->decoder.feed(socket->readAll(), frames);
+    for (const TelemetryFrame& frame : frames)
+        ok = ok && handleFrame(*it, frame);
+
+    if (!ok) {
+        qWarning() << "TelemetryAggregator: dropping corrupt stream from" << socket->peerAddress().toString();
+        socket->abort();
+        dropConnection(socket);
+    }
+}
+
+bool TelemetryAggregator::handleFrame(Connection& connection, const TelemetryFrame& frame) {
+    switch (frame.type) {
+    case HELLO_FRAME:
+        connection.host = frame.host;
+        connection.streams.clear();
+        return true;
+    case GPU_FRAME: {
+        if (connection.host.isEmpty())
+            return false;
+
+        QString key = connection.host + "/" + frame.uuid;
+        auto id = streamIds.constFind(key);
+        if (id == streamIds.constEnd()) {
+            if (streamIds.size() >= MAX_STREAMS)
+                return true; // Ignore the GPU, the rest of the host may still fit
+            id = streamIds.insert(key, streamIds.size());
+            emit streamAdded(id.value(), connection.host, frame.uuid, frame.name);
+        }
+        connection.streams[frame.gpuIndex] = id.value();
+        return true;
+    }
+    case SAMPLE_FRAME: {
+        auto id = connection.streams.constFind(frame.gpuIndex);
+        if (id == connection.streams.constEnd())
+            return true;
+
+        GPUSample sample = frame.sample;
+        sample.gpuId = id.value();
+        emit sampleReceived(sample);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
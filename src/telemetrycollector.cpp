@@ -0,0 +1,57 @@
+#include "include/telemetrycollector.h"
+
+TelemetryCollector::TelemetryCollector(NvidiaControl& nvidia, Sampler& sampler, const QString& hostName,
+                                       const QString& address, quint16 port, QObject* parent)
+    : QObject(parent), nvidia(nvidia), hostName(hostName), address(address), port(port) {
+    socket = new QTcpSocket(this);
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, &QTcpSocket::connected, this, &TelemetryCollector::connected);
+    connect(socket, &QTcpSocket::disconnected, this, &TelemetryCollector::disconnected);
+    connect(socket, static_cast<void (QTcpSocket::*)(QAbstractSocket::SocketError)>(&QTcpSocket::error), this, &TelemetryCollector::disconnected);
+
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, &QTimer::timeout, this, &TelemetryCollector::connectToAggregator);
+
+    connect(&sampler, &Sampler::sampled, this, &TelemetryCollector::sendSample);
+}
+
+void TelemetryCollector::start() {
+    connectToAggregator();
+}
+
+bool TelemetryCollector::isConnected() const {
+    return socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void TelemetryCollector::connectToAggregator() {
+    socket->abort();
+    socket->connectToHost(address, port);
+}
+
+void TelemetryCollector::connected() {
+    reconnectDelay = MIN_RECONNECT_DELAY;
+
+    // The aggregator knows nothing about this stream yet
+    encoder.reset();
+    QByteArray data = encoder.hello(hostName);
+    for (const GPU& gpu : nvidia.getGpus())
+        data += encoder.gpu(gpu.id, gpu.UUID, gpu.productName);
+    socket->write(data);
+}
+
+void TelemetryCollector::disconnected() {
+    // Both error and disconnected may be emitted for the same drop
+    if (reconnectTimer->isActive())
+        return;
+
+    reconnectTimer->start(reconnectDelay);
+    reconnectDelay = qMin(reconnectDelay * 2, int(MAX_RECONNECT_DELAY));
+}
+
+void TelemetryCollector::sendSample(const GPUSample& sample) {
+    // The encoder only advances when a frame is written, so skipped samples do not break the deltas
+    if (!isConnected() || socket->bytesToWrite() > MAX_PENDING_BYTES)
+        return;
+    socket->write(encoder.sample(sample));
+}
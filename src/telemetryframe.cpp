@@ -0,0 +1,196 @@
+#include "include/telemetryframe.h"
+
+static void writeVarint(QByteArray& out, quint64 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+static void writeSigned(QByteArray& out, int value) {
+    writeVarint(out, (static_cast<quint32>(value) << 1) ^ static_cast<quint32>(value >> 31));
+}
+
+static void writeSigned64(QByteArray& out, qint64 value) {
+    writeVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+static void writeString(QByteArray& out, const QString& str) {
+    QByteArray utf8 = str.toUtf8();
+    writeVarint(out, utf8.size());
+    out.append(utf8);
+}
+
+// Returns false if the data ends before the varint does
+static bool readVarint(const char* data, int size, int& pos, quint32& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= size)
+            return false;
+        quint8 byte = static_cast<quint8>(data[pos++]);
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static bool readSigned(const char* data, int size, int& pos, int& value) {
+    quint32 zigzag;
+    if (!readVarint(data, size, pos, zigzag))
+        return false;
+    value = static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+    return true;
+}
+
+static bool readSigned64(const char* data, int size, int& pos, qint64& value) {
+    quint64 zigzag = 0;
+    for (int shift = 0; shift < 70; shift += 7) {
+        if (pos >= size)
+            return false;
+        quint8 byte = static_cast<quint8>(data[pos++]);
+        zigzag |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool readString(const char* data, int size, int& pos, QString& str) {
+    quint32 len;
+    if (!readVarint(data, size, pos, len) || len > static_cast<quint32>(size - pos))
+        return false;
+    str = QString::fromUtf8(data + pos, len);
+    pos += len;
+    return true;
+}
+
+static QByteArray frame(TelemetryFrameType type, const QByteArray& payload) {
+    QByteArray out;
+    writeVarint(out, payload.size() + 1);
+    out.append(static_cast<char>(type));
+    out.append(payload);
+    return out;
+}
+
+QByteArray TelemetryEncoder::hello(const QString& host) {
+    QByteArray payload;
+    writeString(payload, host);
+    return frame(HELLO_FRAME, payload);
+}
+
+QByteArray TelemetryEncoder::gpu(int gpuIndex, const QString& uuid, const QString& name) {
+    QByteArray payload;
+    writeVarint(payload, gpuIndex);
+    writeString(payload, uuid);
+    writeString(payload, name);
+    return frame(GPU_FRAME, payload);
+}
+
+QByteArray TelemetryEncoder::sample(const GPUSample& sample) {
+    int& count = sinceKeyframe[sample.gpuId];
+    bool keyframe = !previous.contains(sample.gpuId) || count >= KEYFRAME_INTERVAL;
+    count = keyframe ? 1 : count + 1;
+
+    GPUSample base = keyframe ? GPUSample() : previous[sample.gpuId];
+    QByteArray payload;
+    writeVarint(payload, sample.gpuId);
+    payload.append(static_cast<char>(keyframe));
+    for (const MetricDescriptor& metric : METRICS)
+        writeSigned(payload, sample.*metric.field - base.*metric.field);
+    writeSigned64(payload, sample.timestamp - base.timestamp);
+
+    previous[sample.gpuId] = sample;
+    return frame(SAMPLE_FRAME, payload);
+}
+
+void TelemetryEncoder::reset() {
+    previous.clear();
+    sinceKeyframe.clear();
+}
+
+bool TelemetryDecoder::feed(const QByteArray& data, QVector<TelemetryFrame>& frames) {
+    buffer.append(data);
+
+    int pos = 0;
+    while (pos < buffer.size()) {
+        int start = pos;
+        quint32 len;
+        if (!readVarint(buffer.constData(), buffer.size(), pos, len)) {
+            // Either the length is incomplete or it is not a varint at all
+            if (buffer.size() - start > 5)
+                return false;
+            pos = start;
+            break;
+        }
+        if (len == 0 || len > MAX_FRAME_SIZE)
+            return false;
+        if (buffer.size() - pos < static_cast<int>(len)) {
+            pos = start;
+            break;
+        }
+
+        TelemetryFrame frame;
+        if (!decodeFrame(buffer.constData() + pos, len, frame))
+            return false;
+        frames.append(frame);
+        pos += len;
+    }
+
+    buffer.remove(0, pos);
+    return true;
+}
+
+bool TelemetryDecoder::decodeFrame(const char* data, int size, TelemetryFrame& frame) {
+    int pos = 1;
+    quint32 gpuIndex;
+    frame.type = static_cast<TelemetryFrameType>(data[0]);
+
+    switch (frame.type) {
+    case HELLO_FRAME:
+        // The stream restarts, GPUs are announced again
+        announced.clear();
+        previous.clear();
+        return readString(data, size, pos, frame.host);
+    case GPU_FRAME:
+        if (!readVarint(data, size, pos, gpuIndex))
+            return false;
+        if (!announced.contains(gpuIndex)) {
+            if (announced.size() >= MAX_GPUS)
+                return false;
+            announced.insert(gpuIndex);
+        }
+        frame.gpuIndex = gpuIndex;
+        return readString(data, size, pos, frame.uuid) && readString(data, size, pos, frame.name);
+    case SAMPLE_FRAME: {
+        if (!readVarint(data, size, pos, gpuIndex) || pos >= size || !announced.contains(gpuIndex))
+            return false;
+        bool keyframe = data[pos++];
+        if (!keyframe && !previous.contains(gpuIndex))
+            return false;
+
+        GPUSample sample = keyframe ? GPUSample() : previous[gpuIndex];
+        sample.gpuId = gpuIndex;
+        for (const MetricDescriptor& metric : METRICS) {
+            int delta;
+            if (!readSigned(data, size, pos, delta))
+                return false;
+            sample.*metric.field += delta;
+        }
+        qint64 timeDelta;
+        if (!readSigned64(data, size, pos, timeDelta))
+            return false;
+        sample.timestamp += timeDelta;
+
+        previous[gpuIndex] = sample;
+        frame.gpuIndex = gpuIndex;
+        frame.sample = sample;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,129 @@
+#include "include/throttledetector.h"
+#include <cmath>
+
+QString ThrottleEvent::causeName(ThrottleCause cause) {
+    switch (cause) {
+    case THERMAL_THROTTLE:
+        return "Thermal";
+    case POWER_THROTTLE:
+        return "Power limit";
+    case CLOCK_COLLAPSE:
+        return "Clock collapse";
+    default:
+        return "None";
+    }
+}
+
+ThrottleDetector::ThrottleDetector(int slowdownTemp) {
+    this->slowdownTemp = slowdownTemp > 0 ? slowdownTemp : FALLBACK_SLOWDOWN_TEMP;
+}
+
+ThrottleCause ThrottleDetector::classify(const GPUSample& sample) const {
+    // Clocks are expected to drop when the GPU is idle
+    if (sample.utilization < LOAD_THRESHOLD || peakClock <= 0)
+        return NO_THROTTLE;
+
+    double ratio = sample.coreClock / peakClock;
+    if (ratio < 1.0 - COLLAPSE_RATIO)
+        return CLOCK_COLLAPSE;
+    if (ratio > 1.0 - DROP_RATIO)
+        return NO_THROTTLE;
+    if (sample.coreTemp >= slowdownTemp - THERMAL_MARGIN)
+        return THERMAL_THROTTLE;
+    return POWER_THROTTLE;
+}
+
+bool ThrottleDetector::addSample(const GPUSample& sample, const QDateTime& time, ThrottleEvent& event) {
+    ThrottleCause cause = classify(sample);
+    qint64 gap = lastTimestamp < 0 ? 0 : sample.timestamp - lastTimestamp;
+
+    // Only busy clocks count towards the peak, which stays frozen while throttling
+    if (sample.utilization >= LOAD_THRESHOLD) {
+        bool settled = cause == NO_THROTTLE && pending == NO_THROTTLE && !inEvent;
+        double decayed = settled ? peakClock * std::pow(1.0 - PEAK_DECAY, gap / 1e6) : peakClock;
+        peakClock = qMax<double>(sample.coreClock, decayed);
+    }
+    lastTimestamp = sample.timestamp;
+
+    if (inEvent) {
+        current.minClock = qMin(current.minClock, sample.coreClock);
+        current.maxTemp = qMax(current.maxTemp, sample.coreTemp);
+    }
+
+    if (cause != pending) {
+        pending = cause;
+        pendingSince = sample.timestamp;
+    }
+
+    // Half a sample interval of tolerance, so jitter in the timestamps does not decide whether the hold
+    // ends on this sample or the next one. A cause always needs two samples, even at long intervals.
+    qint64 held = sample.timestamp - pendingSince;
+    if (held <= 0 || held < HOLD_TIME - gap / 2 || (inEvent && pending == current.cause))
+        return false;
+
+    // If the cause changed, the next sample with the same cause starts a new event
+    if (inEvent) {
+        current.end = time;
+        inEvent = false;
+        event = current;
+        return true;
+    }
+
+    if (pending == NO_THROTTLE)
+        return false;
+
+    inEvent = true;
+    current.gpuId = sample.gpuId;
+    current.cause = pending;
+    current.start = time;
+    current.end = QDateTime();
+    current.timestamp = sample.timestamp;
+    current.peakClock = static_cast<int>(peakClock);
+    current.minClock = sample.coreClock;
+    current.maxTemp = sample.coreTemp;
+    event = current;
+    return true;
+}
+
+ThrottleTimeline::ThrottleTimeline(NvidiaControl& nvidia, Sampler& sampler, QObject* parent) : QObject(parent) {
+    for (const GPU& gpu : nvidia.getGpus()) {
+        int slowdownTemp = 0;
+        try {
+            slowdownTemp = nvidia.getSlowdownTemp(gpu.id);
+        } catch (NvException& e) {
+            qWarning() << e.what();
+        }
+        detectors.insert(gpu.id, ThrottleDetector(slowdownTemp));
+    }
+    connect(&sampler, &Sampler::sampled, this, &ThrottleTimeline::addSample);
+}
+
+const QList<ThrottleEvent>& ThrottleTimeline::getEvents() const {
+    return events;
+}
+
+void ThrottleTimeline::addSample(const GPUSample& sample) {
+    auto it = detectors.find(sample.gpuId);
+    if (it == detectors.end())
+        return;
+
+    ThrottleEvent event;
+    if (!it.value().addSample(sample, QDateTime::currentDateTime(), event))
+        return;
+
+    if (event.end.isValid()) {
+        // Update the ongoing entry of this GPU
+        for (int i = events.size() - 1; i >= 0; i--) {
+            if (events[i].gpuId == event.gpuId && !events[i].end.isValid()) {
+                events[i] = event;
+                break;
+            }
+        }
+        emit eventEnded(event);
+    } else {
+        events.append(event);
+        if (events.size() > MAX_EVENTS)
+            events.removeFirst();
+        emit eventStarted(event);
+    }
+}
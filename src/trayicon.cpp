@@ -0,0 +1,101 @@
+#include "include/trayicon.h"
+
+TrayIcon::TrayIcon(NvidiaControl& nvidia, Settings& settings, Sampler& sampler, ThrottleTimeline& throttleTimeline,
+                   SampleHistory& history, int hiddenInterval, QObject* parent)
+    : QObject(parent), nvidia(nvidia), settings(settings), sampler(sampler), throttleTimeline(throttleTimeline),
+      history(history), hiddenInterval(hiddenInterval) {
+    tray = new QSystemTrayIcon(this);
+    connect(tray, &QSystemTrayIcon::activated, this, &TrayIcon::activated);
+
+    connect(menu.addAction("Show window"), &QAction::triggered, this, &TrayIcon::showWindow);
+    connect(menu.addAction("Hide window"), &QAction::triggered, this, &TrayIcon::hideWindow);
+    menu.addSeparator();
+    connect(menu.addAction("Quit"), &QAction::triggered, QCoreApplication::instance(), &QCoreApplication::quit);
+    tray->setContextMenu(&menu);
+
+    connect(&sampler, &Sampler::sampled, this, [this](const GPUSample& sample) { latest[sample.gpuId] = sample; });
+    connect(&sampler, &Sampler::updated, this, &TrayIcon::updateReadout);
+}
+
+TrayIcon::~TrayIcon() {
+    delete panel;
+}
+
+void TrayIcon::show() {
+    sampler.setInterval(hiddenInterval);
+    updateReadout();
+    tray->show();
+}
+
+void TrayIcon::showWindow() {
+    if (panel) {
+        panel->raise();
+        panel->activateWindow();
+        return;
+    }
+
+    // Deleted when closed, which frees the charts
+    panel = new Panel(nvidia, settings, sampler, throttleTimeline, history);
+    panel->setAttribute(Qt::WA_DeleteOnClose);
+    connect(panel, &QObject::destroyed, this, [this]() { sampler.setInterval(hiddenInterval); });
+    sampler.setInterval(Sampler::SAMPLE_INTERVAL);
+    panel->show();
+}
+
+void TrayIcon::hideWindow() {
+    if (panel)
+        panel->close();
+}
+
+Panel* TrayIcon::window() const {
+    return panel;
+}
+
+void TrayIcon::showNotification(const QString& message) {
+    tray->showMessage("nvOverdrive", message);
+}
+
+void TrayIcon::activated(QSystemTrayIcon::ActivationReason reason) {
+    if (reason != QSystemTrayIcon::Trigger)
+        return;
+
+    if (panel)
+        hideWindow();
+    else
+        showWindow();
+}
+
+void TrayIcon::updateReadout() {
+    QString toolTip;
+    for (auto it = latest.cbegin(); it != latest.cend(); ++it) {
+        if (!toolTip.isEmpty())
+            toolTip += "\n";
+        QStringList readout;
+        for (const MetricDescriptor& metric : METRICS)
+            readout.append(QString("%1 %2 %3").arg(metric.title).arg(it.value().*metric.field).arg(QString::fromUtf8(metric.unit)));
+        toolTip += QString("GPU %1: %2").arg(it.key()).arg(readout.join(", "));
+    }
+    tray->setToolTip(toolTip.isEmpty() ? "nvOverdrive" : toolTip);
+
+    // Only repainted when the shown temperature changes
+    int temp = latest.isEmpty() ? -1 : latest.first().coreTemp;
+    if (temp == iconTemp && !tray->icon().isNull())
+        return;
+    iconTemp = temp;
+
+    QPixmap pixmap(32, 32);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor(40, 40, 40));
+    painter.setPen(Qt::NoPen);
+    painter.drawRoundedRect(pixmap.rect(), 6, 6);
+    QFont font = painter.font();
+    font.setPixelSize(18);
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+    painter.drawText(pixmap.rect(), Qt::AlignCenter, temp < 0 ? "-" : QString::number(temp));
+    painter.end();
+    tray->setIcon(QIcon(pixmap));
+}
@@ -0,0 +1,112 @@
+#include "include/nvtransport.h"
+
+QString XNvTransport::xLibErr;
+
+int XNvTransport::xLibErrorHandler(Display* d, XErrorEvent* e) {
+    char buffer[BUFSIZ];
+    XGetErrorText(d, e->error_code, buffer, BUFSIZ);
+    xLibErr = QString::fromUtf8(buffer);
+    return 0;
+}
+
+QString XNvTransport::getXlibErr() {
+    if (!xLibErr.isNull()) {
+        QString err = xLibErr;
+        xLibErr = QString();
+        return err;
+    }
+    return xLibErr;
+}
+
+XNvTransport::XNvTransport() {
+    // Open X11 display
+    dpy = XOpenDisplay(nullptr);
+    if (dpy == nullptr)
+        throw NvException("Failed to open X display, check if $DISPLAY is set");
+
+    // Set error handler
+    XSetErrorHandler(&xLibErrorHandler);
+
+    // Check if XNVCtrl extension exists
+    if (!XNVCTRLQueryExtension(dpy, &eventBase, &errorBase))
+        throw NvException("NV-CONTROL X extension does not exist on " + QString(XDisplayName(nullptr)));
+}
+
+XNvTransport::~XNvTransport() {
+    if (dpy != nullptr)
+        XCloseDisplay(dpy);
+}
+
+int XNvTransport::queryTargetCount(int targetType) {
+    int count = 0;
+    if (!XNVCTRLQueryTargetCount(dpy, targetType, &count))
+        throw NvException(QString("queryTargetCount %1").arg(targetType));
+    return count;
+}
+
+QString XNvTransport::queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) {
+    char* str;
+    bool ok = XNVCTRLQueryTargetStringAttribute(dpy, targetType, targetId, 0, nvAttribute, &str);
+    QString xlib = getXlibErr();
+    if (!xlib.isNull() || !ok) {
+        XFree(str);
+        throw NvException(QString("queryStringAttribute %1 xlib: %2").arg(nvAttribute).arg(xlib));
+    }
+    QString returnStr = QString::fromUtf8(str);
+    XFree(str);
+    return returnStr;
+}
+
+int XNvTransport::queryAttribute(int targetId, int targetType, unsigned int nvAttribute) {
+    int res;
+    bool ok = XNVCTRLQueryTargetAttribute(dpy, targetType, targetId, 0, nvAttribute, &res);
+    QString xlib = getXlibErr();
+    if (!xlib.isNull() || !ok) {
+        throw NvException(QString("queryAttribute %1 xlib: %2").arg(nvAttribute).arg(xlib));
+    }
+    return res;
+}
+
+NVCTRLAttributeValidValuesRec XNvTransport::queryValidAttributes(int targetId, int targetType, unsigned int nvAttribute) {
+    NVCTRLAttributeValidValuesRec validAttrs;
+    bool ok = XNVCTRLQueryValidTargetAttributeValues(dpy, targetType, targetId, 0, nvAttribute, &validAttrs);
+    QString xlib = getXlibErr();
+    if (!xlib.isNull() || !ok) {
+        throw NvException(QString("queryValidAttributes %1 xlib: %2").arg(nvAttribute).arg(xlib));
+    }
+    return validAttrs;
+}
+
+QByteArray XNvTransport::queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) {
+    unsigned char* data = nullptr;
+    int len = 0;
+    bool ok = XNVCTRLQueryTargetBinaryData(dpy, targetType, targetId, 0, nvAttribute, &data, &len);
+    QString xlib = getXlibErr();
+    if (!xlib.isNull() || !ok) {
+        XFree(data);
+        throw NvException(QString("queryBinaryData %1 xlib: %2").arg(nvAttribute).arg(xlib));
+    }
+    QByteArray result(reinterpret_cast<const char*>(data), len);
+    XFree(data);
+    return result;
+}
+
+void XNvTransport::setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) {
+    bool ok = XNVCTRLSetTargetAttributeAndGetStatus(dpy, targetType, targetId, 0, nvAttribute, value);
+    QString xlib = getXlibErr();
+    if (!xlib.isNull() || !ok) {
+        throw NvException(QString("setAttribute %1 %2 xlib: %3").arg(nvAttribute).arg(value).arg(xlib));
+    }
+}
+
+void XNvTransport::setAttributes(const QVector<NvAttributeWrite>& writes) {
+    // The requests without status are only queued, a single sync sends them in one round trip
+    for (const NvAttributeWrite& write : writes)
+        XNVCTRLSetTargetAttribute(dpy, write.targetType, write.targetId, 0, write.nvAttribute, write.value);
+    XSync(dpy, False);
+
+    QString xlib = getXlibErr();
+    if (!xlib.isNull()) {
+        throw NvException(QString("setAttributes (%1 writes) xlib: %2").arg(writes.size()).arg(xlib));
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef FAKENVTRANSPORT_H
+#define FAKENVTRANSPORT_H
+
+#include <QHash>
+#include "include/nvtransport.h"
+
+// In memory device for tests and benchmarks. Attributes that were never set read as 0.
+class FakeNvTransport : public NvTransport {
+public:
+    int gpuCount;
+    int writes = 0;
+    bool failWrites = false;  // Makes every write throw, like a driver refusing the setting
+    QHash<quint64, int> attributes;
+    QHash<quint64, QString> strings;
+    QHash<quint64, QByteArray> binaryData;
+
+    explicit FakeNvTransport(int gpuCount = 1) : gpuCount(gpuCount) {
+        for (int i = 0; i < gpuCount; i++) {
+            setString(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_PRODUCT_NAME, "Fake GPU");
+            setString(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_VBIOS_VERSION, "1.0");
+            setString(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_NVIDIA_DRIVER_VERSION, "999.99");
+            setString(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UUID, QString("GPU-fake-%1").arg(i));
+            setString(i, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UTILIZATION, "graphics=0, memory=0, video=0, PCIe=0");
+        }
+    }
+
+    static quint64 key(int targetId, int targetType, unsigned int nvAttribute) {
+        return (static_cast<quint64>(targetType) << 48) | (static_cast<quint64>(targetId) << 32) | nvAttribute;
+    }
+
+    void setString(int targetId, int targetType, unsigned int nvAttribute, const QString& value) {
+        strings[key(targetId, targetType, nvAttribute)] = value;
+    }
+
+    // Makes the driver report these cooler targets for a GPU, without it the GPU index is used
+    void setCoolers(int gpuId, const QVector<int>& coolers) {
+        QVector<int> data = coolers;
+        data.prepend(coolers.size());
+        binaryData[key(gpuId, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU)] =
+                QByteArray(reinterpret_cast<const char*>(data.constData()), data.size() * sizeof(int));
+    }
+
+    int get(int targetId, int targetType, unsigned int nvAttribute) const {
+        return attributes.value(key(targetId, targetType, nvAttribute), 0);
+    }
+
+    int queryTargetCount(int targetType) override {
+        return targetType == NV_CTRL_TARGET_TYPE_GPU ? gpuCount : 0;
+    }
+
+    QString queryStringAttribute(int targetId, int targetType, unsigned int nvAttribute) override {
+        auto it = strings.constFind(key(targetId, targetType, nvAttribute));
+        if (it == strings.constEnd())
+            throw NvException(QString("queryStringAttribute %1").arg(nvAttribute));
+        return it.value();
+    }
+
+    int queryAttribute(int targetId, int targetType, unsigned int nvAttribute) override {
+        return get(targetId, targetType, nvAttribute);
+    }
+
+    NVCTRLAttributeValidValuesRec queryValidAttributes(int, int, unsigned int) override {
+        NVCTRLAttributeValidValuesRec validAttrs = {};
+        validAttrs.type = ATTRIBUTE_TYPE_RANGE;
+        validAttrs.u.range.min = -200;
+        validAttrs.u.range.max = 1000;
+        return validAttrs;
+    }
+
+    QByteArray queryBinaryData(int targetId, int targetType, unsigned int nvAttribute) override {
+        auto it = binaryData.constFind(key(targetId, targetType, nvAttribute));
+        if (it == binaryData.constEnd())
+            throw NvException(QString("queryBinaryData %1").arg(nvAttribute));
+        return it.value();
+    }
+
+    void setAttribute(int targetId, int targetType, unsigned int nvAttribute, int value) override {
+        if (failWrites)
+            throw NvException(QString("setAttribute %1").arg(nvAttribute));
+        attributes[key(targetId, targetType, nvAttribute)] = value;
+        writes++;
+    }
+
+    void setAttributes(const QVector<NvAttributeWrite>& batch) override {
+        if (failWrites)
+            throw NvException("setAttributes");
+        for (const NvAttributeWrite& write : batch)
+            attributes[key(write.targetId, write.targetType, write.nvAttribute)] = write.value;
+        writes++;
+    }
+};
+
+#endif // FAKENVTRANSPORT_H
@@ -0,0 +1,17 @@
+#ifndef FAKEPROCESSSOURCE_H
+#define FAKEPROCESSSOURCE_H
+
+#include "include/processevents.h"
+
+// Process events driven by the test
+class FakeProcessSource : public ProcessEventSource {
+    Q_OBJECT
+
+public:
+    bool start() override { return true; }
+
+    void startProcess(int pid, const QString& name) { emit processStarted(pid, name); }
+    void exitProcess(int pid) { emit processExited(pid); }
+};
+
+#endif // FAKEPROCESSSOURCE_H
@@ -0,0 +1,5 @@
+#include "testrunner.h"
+
+int main(int argc, char *argv[]) {
+    return TestRunner::run(argc, argv);
+}
@@ -0,0 +1,56 @@
+#include "testrunner.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QDir>
+#include <QTest>
+#include <memory>
+
+QList<TestRunner::Factory>& TestRunner::factories() {
+    static QList<Factory> registered;
+    return registered;
+}
+
+static QStringList argumentsFor(QStringList args, const QString& className) {
+    for (int i = 1; i + 1 < args.size(); i++) {
+        if (args[i] != "-o")
+            continue;
+
+        QString fileName = args[i+1].section(',', 0, 0);
+        QString format = args[i+1].section(',', 1);
+        if (fileName == "-")
+            continue;
+
+        QFileInfo file(fileName);
+        args[i+1] = file.dir().filePath(className + "-" + file.fileName());
+        if (!format.isEmpty())
+            args[i+1] += "," + format;
+    }
+    return args;
+}
+
+int TestRunner::run(int argc, char** argv) {
+    // Charts need a GUI application, but not a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString onlyClass;
+    int classArg = arguments.indexOf("-class");
+    if (classArg > 0 && classArg + 1 < arguments.size()) {
+        onlyClass = arguments[classArg + 1];
+        arguments.erase(arguments.begin() + classArg, arguments.begin() + classArg + 2);
+    }
+
+    int failed = 0;
+    for (Factory factory : factories()) {
+        std::unique_ptr<QObject> test(factory());
+        if (!onlyClass.isEmpty() && onlyClass != test->metaObject()->className())
+            continue;
+        QStringList args = argumentsFor(arguments, test->metaObject()->className());
+        if (QTest::qExec(test.get(), args) != 0)
+            failed++;
+    }
+    return failed;
+}
@@ -0,0 +1,28 @@
+#ifndef TESTRUNNER_H
+#define TESTRUNNER_H
+
+#include <QObject>
+#include <QList>
+
+// Runs every test class registered with REGISTER_TEST in one executable
+class TestRunner {
+public:
+    using Factory = QObject* (*)();
+
+    template <class T>
+    struct Registration {
+        Registration() { factories().append([]() -> QObject* { return new T(); }); }
+    };
+
+    // Accepts the QTest arguments. With "-o file,format" every class writes
+    // its own file, named <class>-file. "-class <name>" runs only that class.
+    // Returns the number of failed classes.
+    static int run(int argc, char** argv);
+
+private:
+    static QList<Factory>& factories();
+};
+
+#define REGISTER_TEST(Class) static TestRunner::Registration<Class> registration##Class;
+
+#endif // TESTRUNNER_H
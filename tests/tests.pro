@@ -0,0 +1,31 @@
+include(../nvOverdrive.pri)
+
+QT += testlib
+
+TARGET = tests
+TEMPLATE = app
+
+# Adds the tests to "make check"
+CONFIG += testcase
+CONFIG -= app_bundle
+
+SOURCES += \
+    main.cpp \
+    testrunner.cpp \
+    tst_nvidiacontrol.cpp \
+    tst_settings.cpp \
+    tst_rollingstats.cpp \
+    tst_throttledetector.cpp \
+    tst_profileswitcher.cpp \
+    tst_telemetry.cpp \
+    tst_ruleengine.cpp \
+    tst_sampler.cpp \
+    tst_profilecomparison.cpp \
+    tst_samplehistory.cpp \
+    tst_trayicon.cpp \
+    tst_panel.cpp
+
+HEADERS += \
+    testrunner.h \
+    fakenvtransport.h \
+    fakeprocesssource.h
@@ -0,0 +1,128 @@
+#include <QTest>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/nvidiacontrol.h"
+
+class TestNvidiaControl : public QObject {
+    Q_OBJECT
+
+private slots:
+    void enumeratesGpus();
+    void unpacksCurrentClocks();
+    void parsesUtilization();
+    void samplesEveryMetric();
+    void rangesFromDeviceLimits();
+    void appliesProfile();
+    void mapsCoolersToGpus();
+    void setsFansInOneBatch();
+};
+
+void TestNvidiaControl::enumeratesGpus() {
+    NvidiaControl nvidia(new FakeNvTransport(3));
+    QCOMPARE(nvidia.getGpus().size(), 3);
+    QCOMPARE(nvidia.getGpu(2).UUID, QString("GPU-fake-2"));
+}
+
+void TestNvidiaControl::unpacksCurrentClocks() {
+    FakeNvTransport* fake = new FakeNvTransport();
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CURRENT_CLOCK_FREQS, (1850 << 16) | 7000);
+    NvidiaControl nvidia(fake);
+
+    ClockFreqs freqs = nvidia.getCurrentClocks(0);
+    QCOMPARE(freqs.coreClock, 1850);
+    QCOMPARE(freqs.memClock, 7000);
+}
+
+void TestNvidiaControl::parsesUtilization() {
+    FakeNvTransport* fake = new FakeNvTransport();
+    fake->setString(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UTILIZATION, "graphics=87, memory=20, video=0, PCIe=1");
+    NvidiaControl nvidia(fake);
+
+    QCOMPARE(nvidia.getUtilization(0), 87);
+}
+
+void TestNvidiaControl::samplesEveryMetric() {
+    FakeNvTransport* fake = new FakeNvTransport();
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CORE_TEMPERATURE, 64);
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_CURRENT_CLOCK_FREQS, (1850 << 16) | 7000);
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL, 45);
+    fake->setString(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_GPU_UTILIZATION, "graphics=87, memory=20, video=0, PCIe=1");
+    NvidiaControl nvidia(fake);
+
+    GPUSample sample = nvidia.getSample(0);
+    QCOMPARE(sample.coreTemp, 64);
+    QCOMPARE(sample.coreClock, 1850);
+    QCOMPARE(sample.memClock, 7000);
+    QCOMPARE(sample.fanSpeed, 45);
+    QCOMPARE(sample.utilization, 87);
+}
+
+void TestNvidiaControl::rangesFromDeviceLimits() {
+    FakeNvTransport* fake = new FakeNvTransport();
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_MAX_CORE_THRESHOLD, 97);
+    fake->setString(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_STRING_PERFORMANCE_MODES,
+                    "perf=0, nvclock=139, nvclockmax=607, memclockmax=405; perf=2, nvclock=139, nvclockmax=1911, memclockmax=4006");
+    NvidiaControl nvidia(fake);
+
+    // The fake allows offsets up to 1000
+    QCOMPARE(nvidia.getMetricRange(0, METRICS[metricIndex("coreTemp")]), 97);
+    QCOMPARE(nvidia.getMetricRange(0, METRICS[metricIndex("coreClock")]), 1911 + 1000);
+    QCOMPARE(nvidia.getMetricRange(0, METRICS[metricIndex("memClock")]), 4006 + 500);
+    QCOMPARE(nvidia.getMetricRange(0, METRICS[metricIndex("fanSpeed")]), 100);
+
+    // Devices that do not report their limits fall back to the fixed ranges
+    NvidiaControl bare(new FakeNvTransport());
+    QCOMPARE(bare.getMetricRange(0, METRICS[metricIndex("coreClock")]), METRICS[metricIndex("coreClock")].fixedMax);
+}
+
+void TestNvidiaControl::appliesProfile() {
+    FakeNvTransport* fake = new FakeNvTransport();
+    NvidiaControl nvidia(fake);
+
+    nvidia.applyProfile(0, GPUProfile(100, 120, 500, true, 70));
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS), 120);
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_MEM_TRANSFER_RATE_OFFSET_ALL_PERFORMANCE_LEVELS), 500);
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL), int(NV_CTRL_GPU_COOLER_MANUAL_CONTROL_TRUE));
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 70);
+
+    nvidia.applyProfile(0, GPUProfile());
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL), int(NV_CTRL_GPU_COOLER_MANUAL_CONTROL_FALSE));
+}
+
+void TestNvidiaControl::mapsCoolersToGpus() {
+    FakeNvTransport* fake = new FakeNvTransport(2);
+    fake->setCoolers(0, { 0, 1 });
+    fake->setCoolers(1, { 2 });
+    fake->setAttribute(1, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL, 65);
+    fake->setAttribute(2, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL, 30);
+    NvidiaControl nvidia(fake);
+
+    QCOMPARE(nvidia.getGpu(0).coolers, QVector<int>({ 0, 1 }));
+    QCOMPARE(nvidia.getGpu(1).coolers, QVector<int>({ 2 }));
+    QCOMPARE(nvidia.getCoolers(0).size(), 2);
+    QCOMPARE(nvidia.getCoolers(0)[1].currentLevel, 65);
+    QCOMPARE(nvidia.getSample(0).fanSpeed, 65);
+    QCOMPARE(nvidia.getSample(1).fanSpeed, 30);
+}
+
+void TestNvidiaControl::setsFansInOneBatch() {
+    FakeNvTransport* fake = new FakeNvTransport(2);
+    fake->setCoolers(0, { 0, 1, 2 });
+    fake->setCoolers(1, { 3 });
+    NvidiaControl nvidia(fake);
+
+    int writes = fake->writes;
+    nvidia.setManualFanSpeeds(0, { 40, 60 });
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 40);
+    QCOMPARE(fake->get(1, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 60);
+    QCOMPARE(fake->get(2, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 60);
+    QCOMPARE(fake->get(3, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 0);
+    // Enabling manual control, then all fan levels at once
+    QCOMPARE(fake->writes - writes, 2);
+
+    nvidia.applyProfile(1, GPUProfile(100, 0, 0, true, 80));
+    QCOMPARE(fake->get(3, NV_CTRL_TARGET_TYPE_COOLER, NV_CTRL_THERMAL_COOLER_LEVEL), 80);
+}
+
+REGISTER_TEST(TestNvidiaControl)
+#include "tst_nvidiacontrol.moc"
@@ -0,0 +1,45 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QPushButton>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/panel.h"
+
+class TestPanel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void savingKeepsUneditedFields();
+};
+
+void TestPanel::savingKeepsUneditedFields() {
+    QTemporaryDir dir;
+    QString configFile = dir.filePath("panel.config");
+    NvidiaControl nvidia(new FakeNvTransport());
+    const QString& uuid = nvidia.getGpu(0).UUID;
+    {
+        Settings settings(configFile);
+        GPUProfile quiet(90, 50, 100, true, 40);
+        quiet.fanSpeeds = { 40, 60 };
+        settings.newProfile(uuid, "Quiet");
+        settings.editProfile(uuid, quiet, "Quiet");
+    }
+
+    Settings settings(configFile);
+    SampleCache cache;
+    Sampler sampler(nvidia, cache);
+    ThrottleTimeline timeline(nvidia, sampler);
+    SampleHistory history(1);
+    Panel panel(nvidia, settings, sampler, timeline, history);
+    panel.findChild<QPushButton*>("btnSaveProfile")->click();
+
+    Settings reloaded(configFile);
+    GPUProfile saved = reloaded.getProfile(uuid, "Quiet");
+    QCOMPARE(saved.powerLimit, 90);
+    QCOMPARE(saved.coreClock, 50);
+    QCOMPARE(saved.fanSpeed, 40);
+    QCOMPARE(saved.fanSpeeds, QVector<int>({ 40, 60 }));
+}
+
+REGISTER_TEST(TestPanel)
+#include "tst_panel.moc"
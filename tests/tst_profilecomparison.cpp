@@ -0,0 +1,88 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "testrunner.h"
+#include "include/profilecomparison.h"
+#include "include/simulatednvtransport.h"
+#include "fakenvtransport.h"
+
+class TestProfileComparison : public QObject {
+    Q_OBJECT
+
+private slots:
+    void alternatesProfiles();
+    void discardsWarmup();
+    void measuresClockDifference();
+    void stopsWhenProfileFails();
+
+private:
+    // Feeds samples of the simulated device until the comparison is done
+    void run(NvidiaControl& nvidia, ProfileComparison& comparison);
+};
+
+void TestProfileComparison::run(NvidiaControl& nvidia, ProfileComparison& comparison) {
+    comparison.start();
+    for (int i = 0; i < 10000 && !comparison.isFinished(); i++)
+        comparison.addSample(nvidia.getSample(0));
+}
+
+void TestProfileComparison::alternatesProfiles() {
+    NvidiaControl nvidia(new SimulatedNvTransport(1, "test"));
+    ProfileComparison comparison(nvidia, 0, { "A", "B" }, { GPUProfile(100, 0), GPUProfile(100, 100) }, 5, 1, 3);
+    QSignalSpy phases(&comparison, &ProfileComparison::phaseStarted);
+    QSignalSpy finished(&comparison, &ProfileComparison::finished);
+
+    run(nvidia, comparison);
+    QCOMPARE(finished.count(), 1);
+    QStringList order;
+    for (const QList<QVariant>& args : phases)
+        order.append(args[1].toString());
+    QCOMPARE(order, QStringList({ "A", "B", "B", "A", "A", "B" }));
+}
+
+void TestProfileComparison::discardsWarmup() {
+    NvidiaControl nvidia(new SimulatedNvTransport(1, "test"));
+    ProfileComparison comparison(nvidia, 0, { "A", "B" }, { GPUProfile(100, 0), GPUProfile(100, 100) }, 10, 4, 2);
+
+    run(nvidia, comparison);
+    QVector<QVector<MetricSummary>> summaries = comparison.summaries();
+    QCOMPARE(summaries[0][0].count, 2 * (10 - 4));
+    QCOMPARE(summaries[1][0].count, 2 * (10 - 4));
+}
+
+void TestProfileComparison::measuresClockDifference() {
+    NvidiaControl nvidia(new SimulatedNvTransport(1, "test"));
+    ProfileComparison comparison(nvidia, 0, { "Stock", "Overclock" }, { GPUProfile(100, 0), GPUProfile(100, 150) }, 20, 5, 4);
+
+    run(nvidia, comparison);
+    const MetricDifference& clock = comparison.differences()[1][metricIndex("coreClock")];
+    QVERIFY(clock.hasInterval);
+    QVERIFY(qAbs(clock.mean - 150) < 5);
+    QVERIFY(clock.meanLow <= clock.mean && clock.mean <= clock.meanHigh);
+    QVERIFY(qAbs(clock.p95 - 150) < 5);
+
+    // The offset does not change the utilization
+    const MetricDifference& utilization = comparison.differences()[1][metricIndex("utilization")];
+    QVERIFY(qAbs(utilization.mean) < 5);
+    QVERIFY(comparison.report().contains("Overclock - Stock"));
+}
+
+void TestProfileComparison::stopsWhenProfileFails() {
+    FakeNvTransport* transport = new FakeNvTransport(1);
+    NvidiaControl nvidia(transport);
+    ProfileComparison comparison(nvidia, 0, { "A", "B" }, { GPUProfile(100, 0), GPUProfile(100, 100) }, 5, 1, 2);
+    QSignalSpy failed(&comparison, &ProfileComparison::failed);
+    QSignalSpy finished(&comparison, &ProfileComparison::finished);
+
+    comparison.start();
+    transport->failWrites = true;
+    for (int i = 0; i < 50; i++)
+        comparison.addSample(nvidia.getSample(0));
+
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(finished.count(), 0);
+    QCOMPARE(comparison.completedPhases(), 1);
+    QVERIFY(comparison.getError().contains("B"));
+}
+
+REGISTER_TEST(TestProfileComparison)
+#include "tst_profilecomparison.moc"
@@ -0,0 +1,110 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "fakeprocesssource.h"
+#include "include/profileswitcher.h"
+
+class TestProfileSwitcher : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void switchesOnStartAndExit();
+    void lastStartedProcessWins();
+    void returnsToApplyOnStartProfile();
+    void matchesTruncatedNames();
+
+private:
+    QTemporaryDir dir;
+    FakeNvTransport* fake;
+    NvidiaControl* nvidia;
+    Settings* settings;
+    FakeProcessSource* source;
+    ProfileSwitcher* switcher;
+
+    int coreOffset() { return fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS); }
+    void addProfile(const QString& name, int coreClock);
+};
+
+void TestProfileSwitcher::init() {
+    fake = new FakeNvTransport();
+    nvidia = new NvidiaControl(fake);
+    QFile::remove(dir.filePath("switcher.config"));
+    settings = new Settings(dir.filePath("switcher.config"));
+    source = new FakeProcessSource();
+    switcher = nullptr;
+}
+
+void TestProfileSwitcher::cleanup() {
+    delete switcher;
+    delete source;
+    delete settings;
+    delete nvidia;
+}
+
+void TestProfileSwitcher::addProfile(const QString& name, int coreClock) {
+    settings->newProfile("GPU-fake-0", name);
+    settings->editProfile("GPU-fake-0", GPUProfile(100, coreClock), name);
+}
+
+void TestProfileSwitcher::switchesOnStartAndExit() {
+    addProfile("Game", 150);
+    settings->addProcessRule(ProcessRule("game", "GPU-fake-0", "Game"));
+    switcher = new ProfileSwitcher(*nvidia, *settings, source);
+    switcher->start();
+
+    source->startProcess(100, "editor");
+    QCOMPARE(coreOffset(), 0);
+    source->startProcess(101, "game");
+    QCOMPARE(coreOffset(), 150);
+    QCOMPARE(switcher->getActiveProfile(0), QString("Game"));
+
+    source->exitProcess(100);
+    QCOMPARE(coreOffset(), 150);
+    source->exitProcess(101);
+    QCOMPARE(coreOffset(), 0);
+    QVERIFY(switcher->getActiveProfile(0).isEmpty());
+}
+
+void TestProfileSwitcher::lastStartedProcessWins() {
+    addProfile("Game", 150);
+    addProfile("Render", -100);
+    settings->addProcessRule(ProcessRule("game", "GPU-fake-0", "Game"));
+    settings->addProcessRule(ProcessRule("blender", "GPU-fake-0", "Render"));
+    switcher = new ProfileSwitcher(*nvidia, *settings, source);
+    switcher->start();
+
+    source->startProcess(1, "game");
+    source->startProcess(2, "blender");
+    QCOMPARE(coreOffset(), -100);
+    source->exitProcess(2);
+    QCOMPARE(coreOffset(), 150);
+}
+
+void TestProfileSwitcher::returnsToApplyOnStartProfile() {
+    addProfile("Base", 50);
+    addProfile("Game", 150);
+    settings->setApplyOnStart("GPU-fake-0", "Base", true);
+    settings->addProcessRule(ProcessRule("game", "GPU-fake-0", "Game"));
+    switcher = new ProfileSwitcher(*nvidia, *settings, source);
+    switcher->start();
+
+    source->startProcess(1, "game");
+    source->exitProcess(1);
+    QCOMPARE(coreOffset(), 50);
+}
+
+void TestProfileSwitcher::matchesTruncatedNames() {
+    addProfile("Game", 150);
+    settings->addProcessRule(ProcessRule("averylongexecutablename", "GPU-fake-0", "Game"));
+    switcher = new ProfileSwitcher(*nvidia, *settings, source);
+    switcher->start();
+
+    source->startProcess(1, "averylongexecut");
+    QCOMPARE(coreOffset(), 150);
+}
+
+REGISTER_TEST(TestProfileSwitcher)
+#include "tst_profileswitcher.moc"
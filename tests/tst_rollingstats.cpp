@@ -0,0 +1,71 @@
+#include <QTest>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "testrunner.h"
+#include "include/rollingstats.h"
+
+class TestRollingStats : public QObject {
+    Q_OBJECT
+
+private slots:
+    void matchesBruteForce_data();
+    void matchesBruteForce();
+    void emptyWindow();
+};
+
+void TestRollingStats::matchesBruteForce_data() {
+    QTest::addColumn<int>("window");
+    QTest::addColumn<int>("maxGap");
+    QTest::newRow("1") << 1 << 1;
+    QTest::newRow("10") << 10 << 1;
+    QTest::newRow("300") << 300 << 1;
+    // Irregular intervals, like a sampler that changes its rate or misses ticks
+    QTest::newRow("300 irregular") << 300 << 7;
+}
+
+void TestRollingStats::matchesBruteForce() {
+    QFETCH(int, window);
+    QFETCH(int, maxGap);
+    const int rangeMax = 3000;
+    RollingStats stats(window, rangeMax);
+    std::vector<std::pair<long long, int>> values;
+    std::mt19937 random(42);
+    long long time = 0;
+
+    for (int i = 0; i < 2000; i++) {
+        time += 1 + random() % maxGap;
+        int value = random() % (rangeMax + 1);
+        stats.add(time, value);
+        values.emplace_back(time, value);
+
+        std::vector<int> inWindow;
+        for (const auto& entry : values) {
+            if (entry.first > time - window)
+                inWindow.push_back(entry.second);
+        }
+        std::sort(inWindow.begin(), inWindow.end());
+        double sum = 0;
+        for (int v : inWindow)
+            sum += v;
+
+        QCOMPARE(stats.count(), static_cast<int>(inWindow.size()));
+        QCOMPARE(stats.min(), inWindow.front());
+        QCOMPARE(stats.max(), inWindow.back());
+        QVERIFY(qAbs(stats.mean() - sum / inWindow.size()) < 1e-6);
+
+        // Quantiles are exact up to the bucket width
+        int tolerance = rangeMax / RollingStats::DEFAULT_BUCKETS + 1;
+        int exact = inWindow[std::max(0, static_cast<int>(std::ceil(0.95 * inWindow.size())) - 1)];
+        QVERIFY2(qAbs(stats.quantile(0.95) - exact) <= tolerance, qPrintable(QString("p95 %1 vs %2").arg(stats.quantile(0.95)).arg(exact)));
+    }
+}
+
+void TestRollingStats::emptyWindow() {
+    RollingStats stats(60, 100);
+    QCOMPARE(stats.count(), 0);
+    QCOMPARE(stats.quantile(0.99), 0);
+}
+
+REGISTER_TEST(TestRollingStats)
+#include "tst_rollingstats.moc"
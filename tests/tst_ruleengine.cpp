@@ -0,0 +1,161 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/ruleengine.h"
+#include "include/sampler.h"
+
+class TestRuleEngine : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void firesAfterDurationOnce();
+    void rearmsWhenConditionClears();
+    void measuresDurationInTime();
+    void appliesFallbackProfile();
+    void setsFansToAuto();
+    void requiresAllConditions();
+    void skipsInvalidRules();
+
+private:
+    QTemporaryDir dir;
+    FakeNvTransport* fake;
+    NvidiaControl* nvidia;
+    Settings* settings;
+    qint64 now;
+
+    // Samples are a sampling interval apart
+    GPUSample sample(int coreTemp, int fanSpeed = 50, int utilization = 0);
+    AlertRule hotRule(int duration, const QString& action = "notify", const QString& argument = QString());
+};
+
+void TestRuleEngine::init() {
+    fake = new FakeNvTransport();
+    nvidia = new NvidiaControl(fake);
+    QFile::remove(dir.filePath("rules.config"));
+    settings = new Settings(dir.filePath("rules.config"));
+    now = 0;
+}
+
+void TestRuleEngine::cleanup() {
+    delete settings;
+    delete nvidia;
+}
+
+GPUSample TestRuleEngine::sample(int coreTemp, int fanSpeed, int utilization) {
+    GPUSample s = {};
+    s.gpuId = 0;
+    s.coreTemp = coreTemp;
+    s.fanSpeed = fanSpeed;
+    s.utilization = utilization;
+    s.timestamp = now;
+    now += Sampler::SAMPLE_INTERVAL * 1000;
+    return s;
+}
+
+AlertRule TestRuleEngine::hotRule(int duration, const QString& action, const QString& argument) {
+    AlertRule rule("Hot", "GPU-fake-0", duration, action, argument);
+    rule.conditions.append(AlertCondition("coreTemp", ">", 85));
+    return rule;
+}
+
+void TestRuleEngine::firesAfterDurationOnce() {
+    settings->addAlertRule(hotRule(3 * Sampler::SAMPLE_INTERVAL / 1000));
+    RuleEngine engine(*nvidia, *settings);
+    QSignalSpy spy(&engine, &RuleEngine::ruleTriggered);
+
+    // Held from the first sample until three intervals later
+    engine.evaluate(sample(90));
+    engine.evaluate(sample(90));
+    engine.evaluate(sample(90));
+    QCOMPARE(spy.count(), 0);
+    engine.evaluate(sample(90));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("Hot"));
+
+    for (int i = 0; i < 10; i++)
+        engine.evaluate(sample(90));
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestRuleEngine::rearmsWhenConditionClears() {
+    settings->addAlertRule(hotRule(0));
+    RuleEngine engine(*nvidia, *settings);
+    QSignalSpy spy(&engine, &RuleEngine::ruleTriggered);
+
+    engine.evaluate(sample(90));
+    engine.evaluate(sample(80));
+    engine.evaluate(sample(90));
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestRuleEngine::measuresDurationInTime() {
+    settings->addAlertRule(hotRule(10));
+    RuleEngine engine(*nvidia, *settings);
+    QSignalSpy spy(&engine, &RuleEngine::ruleTriggered);
+
+    // Fewer samples when sampling slows down, the rule still fires after 10 seconds
+    GPUSample hot = sample(90);
+    engine.evaluate(hot);
+    hot.timestamp += 5000000;
+    engine.evaluate(hot);
+    QCOMPARE(spy.count(), 0);
+    hot.timestamp += 5000000;
+    engine.evaluate(hot);
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestRuleEngine::appliesFallbackProfile() {
+    settings->newProfile("GPU-fake-0", "Quiet");
+    settings->editProfile("GPU-fake-0", GPUProfile(100, -100), "Quiet");
+    settings->addAlertRule(hotRule(0, "profile", "Quiet"));
+    RuleEngine engine(*nvidia, *settings);
+
+    engine.evaluate(sample(90));
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS), -100);
+}
+
+void TestRuleEngine::setsFansToAuto() {
+    fake->setAttribute(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL, NV_CTRL_GPU_COOLER_MANUAL_CONTROL_TRUE);
+    settings->addAlertRule(hotRule(0, "fanAuto"));
+    RuleEngine engine(*nvidia, *settings);
+
+    engine.evaluate(sample(90));
+    QCOMPARE(fake->get(0, NV_CTRL_TARGET_TYPE_GPU, NV_CTRL_GPU_COOLER_MANUAL_CONTROL), int(NV_CTRL_GPU_COOLER_MANUAL_CONTROL_FALSE));
+}
+
+void TestRuleEngine::requiresAllConditions() {
+    // Fan stuck at 0 while under load
+    AlertRule rule("Fan stuck", QString(), 0, "notify");
+    rule.conditions.append(AlertCondition("fanSpeed", "==", 0));
+    rule.conditions.append(AlertCondition("utilization", ">=", 50));
+    settings->addAlertRule(rule);
+    RuleEngine engine(*nvidia, *settings);
+    QSignalSpy spy(&engine, &RuleEngine::notification);
+
+    engine.evaluate(sample(60, 0, 10));
+    engine.evaluate(sample(60, 40, 90));
+    QCOMPARE(spy.count(), 0);
+    engine.evaluate(sample(60, 0, 90));
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestRuleEngine::skipsInvalidRules() {
+    AlertRule badMetric("Bad", QString(), 0, "notify");
+    badMetric.conditions.append(AlertCondition("voltage", ">", 1));
+    AlertRule badGpu = hotRule(0);
+    badGpu.gpuUUID = "GPU-missing";
+    settings->addAlertRule(badMetric);
+    settings->addAlertRule(badGpu);
+    settings->addAlertRule(hotRule(0, "explode"));
+    settings->addAlertRule(hotRule(0));
+    RuleEngine engine(*nvidia, *settings);
+
+    QCOMPARE(engine.ruleCount(), 1);
+}
+
+REGISTER_TEST(TestRuleEngine)
+#include "tst_ruleengine.moc"
@@ -0,0 +1,66 @@
+#include <QTest>
+#include "testrunner.h"
+#include "include/samplehistory.h"
+
+class TestSampleHistory : public QObject {
+    Q_OBJECT
+
+private slots:
+    void rebuildsSamples();
+    void keepsNewestWhenFull();
+    void clampsValues();
+};
+
+static GPUSample makeSample(int gpuId, qint64 timestamp, int value) {
+    GPUSample sample = {};
+    sample.gpuId = gpuId;
+    sample.timestamp = timestamp;
+    for (const MetricDescriptor& metric : METRICS)
+        sample.*metric.field = value;
+    return sample;
+}
+
+void TestSampleHistory::rebuildsSamples() {
+    SampleHistory history(2);
+    const qint64 start = 5000000000000LL;
+    history.add(makeSample(0, start, 40));
+    history.add(makeSample(1, start, 99));
+    history.add(makeSample(0, start + 1000250, 41));
+    history.add(makeSample(0, start + 6000500, 42));
+
+    QVector<GPUSample> samples = history.get(0);
+    QCOMPARE(samples.size(), 3);
+    QCOMPARE(samples[0].coreTemp, 40);
+    QCOMPARE(samples[2].fanSpeed, 42);
+    QCOMPARE(samples[2].gpuId, 0);
+
+    // Times are kept to the millisecond
+    QVERIFY(qAbs(samples[1].timestamp - (start + 1000250)) < 1000);
+    QVERIFY(qAbs(samples[2].timestamp - (start + 6000500)) < 1000);
+    QCOMPARE(history.get(1).size(), 1);
+    QVERIFY(history.get(2).isEmpty());
+}
+
+void TestSampleHistory::keepsNewestWhenFull() {
+    SampleHistory history(1);
+    const int total = SampleHistory::HISTORY_SIZE + 50;
+    for (int i = 0; i < total; i++)
+        history.add(makeSample(0, i * 1000000LL, i % 1000));
+
+    QVector<GPUSample> samples = history.get(0);
+    QCOMPARE(samples.size(), static_cast<int>(SampleHistory::HISTORY_SIZE));
+    QCOMPARE(samples.first().coreClock, 50);
+    QCOMPARE(samples.last().coreClock, total - 1);
+    QCOMPARE(samples.last().timestamp, (total - 1) * 1000000LL);
+    for (int i = 1; i < samples.size(); i++)
+        QCOMPARE(samples[i].timestamp - samples[i - 1].timestamp, 1000000LL);
+}
+
+void TestSampleHistory::clampsValues() {
+    SampleHistory history(1);
+    history.add(makeSample(0, 0, 100000));
+    QCOMPARE(history.get(0)[0].memClock, 32767);
+}
+
+REGISTER_TEST(TestSampleHistory)
+#include "tst_samplehistory.moc"
@@ -0,0 +1,88 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QThread>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/sampler.h"
+
+class TestSampler : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void stampsSamplesOnSchedule();
+    void recordsMissedTicks();
+
+private:
+    static void verifyAligned(const Sampler& sampler, qint64 start, qint64 stop, int interval);
+};
+
+void TestSampler::initTestCase() {
+    qRegisterMetaType<GPUSample>();
+}
+
+// Every deadline from start to stop is either ticked or counted as missed, so their sum tracks the elapsed
+// intervals however late single ticks run. A sampler that re-arms from the end of a tick falls behind instead.
+// The deadline just before stop may not have been served yet, hence the tolerance of one.
+void TestSampler::verifyAligned(const Sampler& sampler, qint64 start, qint64 stop, int interval) {
+    const SamplerTiming& timing = sampler.getTiming();
+    qint64 deadlines = static_cast<qint64>(timing.ticks + timing.missedTicks);
+    qint64 elapsed = (stop - start) / (interval * 1000);
+    QVERIFY2(qAbs(deadlines - elapsed) <= 1,
+             qPrintable(QString("%1 deadlines served in %2 intervals").arg(deadlines).arg(elapsed)));
+}
+
+void TestSampler::stampsSamplesOnSchedule() {
+    const int interval = 20;
+    NvidiaControl nvidia(new FakeNvTransport());
+    SampleCache cache;
+    Sampler sampler(nvidia, cache);
+    QSignalSpy spy(&sampler, &Sampler::sampled);
+
+    // Each tick takes a quarter interval, a drifting schedule would lose a whole interval every four ticks
+    connect(&sampler, &Sampler::sampled, this, []() { QThread::msleep(interval / 4); });
+
+    qint64 start = Sampler::monotonicTime();
+    sampler.start(interval);
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 20, 5000);
+    qint64 stop = Sampler::monotonicTime();
+    sampler.stop();
+
+    verifyAligned(sampler, start, stop, interval);
+    for (int i = 1; i < spy.count(); i++)
+        QVERIFY(spy.at(i).at(0).value<GPUSample>().timestamp > spy.at(i - 1).at(0).value<GPUSample>().timestamp);
+    QCOMPARE(cache.getTiming().ticks, sampler.getTiming().ticks);
+}
+
+void TestSampler::recordsMissedTicks() {
+    const int interval = 20;
+    NvidiaControl nvidia(new FakeNvTransport());
+    SampleCache cache;
+    Sampler sampler(nvidia, cache);
+    QSignalSpy spy(&sampler, &Sampler::sampled);
+    QSignalSpy missed(&sampler, &Sampler::ticksMissed);
+
+    // Block the event loop for several intervals on the first tick
+    bool blocked = false;
+    connect(&sampler, &Sampler::sampled, this, [&blocked]() {
+        if (!blocked)
+            QThread::msleep(5 * interval);
+        blocked = true;
+    });
+    qint64 start = Sampler::monotonicTime();
+    sampler.start(interval);
+    QTRY_VERIFY_WITH_TIMEOUT(missed.count() > 0 && spy.count() >= 10, 5000);
+    qint64 stop = Sampler::monotonicTime();
+    sampler.stop();
+
+    // The skipped deadlines are reported, and the ticks after the block stay on the original schedule
+    int reported = 0;
+    for (const QList<QVariant>& args : missed)
+        reported += args[0].toInt();
+    QVERIFY(reported >= 3);
+    QCOMPARE(sampler.getTiming().missedTicks, static_cast<quint64>(reported));
+    verifyAligned(sampler, start, stop, interval);
+}
+
+REGISTER_TEST(TestSampler)
+#include "tst_sampler.moc"
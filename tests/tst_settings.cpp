@@ -0,0 +1,98 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "include/settings.h"
+
+class TestSettings : public QObject {
+    Q_OBJECT
+
+private slots:
+    void createsDefaultProfile();
+    void roundTripsProfiles();
+    void roundTripsProcessRules();
+    void roundTripsAlertRules();
+    void deletingProfileClearsApplyOnStart();
+
+private:
+    QTemporaryDir dir;
+    QString configPath(const QString& name) { return dir.filePath(name); }
+};
+
+void TestSettings::createsDefaultProfile() {
+    Settings settings(configPath("default.config"));
+    const auto& profiles = settings.getGPUProfiles("GPU-a");
+    QCOMPARE(profiles.size(), 1);
+    QVERIFY(profiles.contains("Default"));
+}
+
+void TestSettings::roundTripsProfiles() {
+    QString path = configPath("profiles.config");
+    {
+        Settings settings(path);
+        settings.newProfile("GPU-a", "Silent");
+        GPUProfile profile(90, -50, 200, true, 35);
+        profile.fanSpeeds = { 35, 50 };
+        settings.editProfile("GPU-a", profile, "Silent");
+        settings.setApplyOnStart("GPU-a", "Silent", true);
+    }
+
+    Settings settings(path);
+    const GPUProfile& profile = settings.getProfile("GPU-a", "Silent");
+    QCOMPARE(profile.powerLimit, 90);
+    QCOMPARE(profile.coreClock, -50);
+    QCOMPARE(profile.memClock, 200);
+    QCOMPARE(profile.manualFanControl, true);
+    QCOMPARE(profile.fanSpeed, 35);
+    QCOMPARE(profile.fanSpeeds, QVector<int>({ 35, 50 }));
+    QCOMPARE(settings.getApplyOnStart("GPU-a"), QString("Silent"));
+}
+
+void TestSettings::roundTripsProcessRules() {
+    QString path = configPath("rules.config");
+    {
+        Settings settings(path);
+        settings.addProcessRule(ProcessRule("blender", "GPU-a", "Render"));
+        settings.addProcessRule(ProcessRule("game", "GPU-b", "Fast"));
+        settings.removeProcessRule(0);
+    }
+
+    Settings settings(path);
+    QCOMPARE(settings.getProcessRules().size(), 1);
+    QCOMPARE(settings.getProcessRules()[0].executable, QString("game"));
+    QCOMPARE(settings.getProcessRules()[0].gpuUUID, QString("GPU-b"));
+    QCOMPARE(settings.getProcessRules()[0].profileName, QString("Fast"));
+}
+
+void TestSettings::roundTripsAlertRules() {
+    QString path = configPath("alerts.config");
+    {
+        Settings settings(path);
+        AlertRule rule("Hot", "GPU-a", 30, "profile", "Silent");
+        rule.conditions.append(AlertCondition("coreTemp", ">", 85));
+        rule.conditions.append(AlertCondition("fanSpeed", "<", 40));
+        settings.addAlertRule(rule);
+    }
+
+    Settings settings(path);
+    QCOMPARE(settings.getAlertRules().size(), 1);
+    const AlertRule& rule = settings.getAlertRules()[0];
+    QCOMPARE(rule.name, QString("Hot"));
+    QCOMPARE(rule.duration, 30);
+    QCOMPARE(rule.action, QString("profile"));
+    QCOMPARE(rule.argument, QString("Silent"));
+    QCOMPARE(rule.conditions.size(), 2);
+    QCOMPARE(rule.conditions[1].metric, QString("fanSpeed"));
+    QCOMPARE(rule.conditions[1].op, QString("<"));
+    QCOMPARE(rule.conditions[1].value, 40);
+}
+
+void TestSettings::deletingProfileClearsApplyOnStart() {
+    Settings settings(configPath("delete.config"));
+    settings.newProfile("GPU-a", "Loud");
+    settings.setApplyOnStart("GPU-a", "Loud", true);
+    settings.deleteProfile("GPU-a", "Loud");
+    QVERIFY(settings.getApplyOnStart("GPU-a").isEmpty());
+}
+
+REGISTER_TEST(TestSettings)
+#include "tst_settings.moc"
@@ -0,0 +1,139 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "testrunner.h"
+#include "include/telemetrycollector.h"
+#include "include/telemetryaggregator.h"
+#include "include/simulatednvtransport.h"
+
+class TestTelemetry : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTripsFrames();
+    void rejectsDeltaWithoutKeyframe();
+    void rejectsUnannouncedGpus();
+    void aggregatesLoopbackHosts();
+    void reconnectsAfterDrop();
+
+private:
+    // A simulated host streaming to the aggregator
+    struct Host {
+        NvidiaControl nvidia;
+        SampleCache cache;
+        Sampler sampler;
+        TelemetryCollector collector;
+
+        Host(const QString& name, int gpus, quint16 port)
+            : nvidia(new SimulatedNvTransport(gpus, name)), sampler(nvidia, cache),
+              collector(nvidia, sampler, name, "127.0.0.1", port) {
+            collector.start();
+            sampler.start(20);
+        }
+    };
+};
+
+void TestTelemetry::initTestCase() {
+    qRegisterMetaType<GPUSample>();
+}
+
+void TestTelemetry::roundTripsFrames() {
+    TelemetryEncoder encoder;
+    QByteArray stream = encoder.hello("node1") + encoder.gpu(0, "GPU-a", "Test GPU");
+    QVector<GPUSample> sent;
+    for (int i = 0; i < TelemetryEncoder::KEYFRAME_INTERVAL * 2 + 5; i++) {
+        GPUSample sample = { 0, 40 + i % 30, 1500 + (i * 37) % 400, 7000 - i, i % 101, (i * 13) % 100,
+                             5000000000000LL + i * 1000000LL + (i % 3) * 250 };
+        sent.append(sample);
+        stream += encoder.sample(sample);
+    }
+
+    // Deliver the stream in odd sized pieces
+    TelemetryDecoder decoder;
+    QVector<TelemetryFrame> frames;
+    for (int pos = 0; pos < stream.size(); pos += 7)
+        QVERIFY(decoder.feed(stream.mid(pos, 7), frames));
+
+    QCOMPARE(frames.size(), sent.size() + 2);
+    QCOMPARE(frames[0].host, QString("node1"));
+    QCOMPARE(frames[1].uuid, QString("GPU-a"));
+    QCOMPARE(frames[1].name, QString("Test GPU"));
+    for (int i = 0; i < sent.size(); i++) {
+        const GPUSample& received = frames[i + 2].sample;
+        QCOMPARE(received.coreTemp, sent[i].coreTemp);
+        QCOMPARE(received.coreClock, sent[i].coreClock);
+        QCOMPARE(received.memClock, sent[i].memClock);
+        QCOMPARE(received.fanSpeed, sent[i].fanSpeed);
+        QCOMPARE(received.utilization, sent[i].utilization);
+        QCOMPARE(received.timestamp, sent[i].timestamp);
+    }
+}
+
+void TestTelemetry::rejectsDeltaWithoutKeyframe() {
+    TelemetryEncoder encoder;
+    GPUSample sample = { 0, 50, 1500, 7000, 40, 90 };
+    encoder.sample(sample);
+    QByteArray delta = encoder.sample(sample);
+
+    TelemetryDecoder decoder;
+    QVector<TelemetryFrame> frames;
+    QVERIFY(decoder.feed(encoder.hello("node1") + encoder.gpu(0, "GPU-a", "Test GPU"), frames));
+    QVERIFY(!decoder.feed(delta, frames));
+}
+
+void TestTelemetry::rejectsUnannouncedGpus() {
+    TelemetryEncoder encoder;
+    GPUSample sample = { 7, 50, 1500, 7000, 40, 90 };
+    QByteArray stream = encoder.hello("node1") + encoder.gpu(0, "GPU-a", "Test GPU") + encoder.sample(sample);
+
+    TelemetryDecoder decoder;
+    QVector<TelemetryFrame> frames;
+    QVERIFY(!decoder.feed(stream, frames));
+
+    // Announcing more GPUs than a host can have is corrupt as well
+    TelemetryDecoder flooded;
+    QByteArray gpus = encoder.hello("node1");
+    for (int i = 0; i <= TelemetryDecoder::MAX_GPUS; i++)
+        gpus += encoder.gpu(i, QString("GPU-%1").arg(i), "Test GPU");
+    QVERIFY(!flooded.feed(gpus, frames));
+}
+
+void TestTelemetry::aggregatesLoopbackHosts() {
+    TelemetryAggregator aggregator;
+    QVERIFY(aggregator.listen(0, QHostAddress::LocalHost));
+    QSignalSpy samples(&aggregator, &TelemetryAggregator::sampleReceived);
+
+    Host a("host-a", 2, aggregator.serverPort());
+    Host b("host-b", 3, aggregator.serverPort());
+    QTRY_COMPARE(aggregator.streamCount(), 5);
+    QTRY_VERIFY(samples.count() >= 50);
+
+    for (const QList<QVariant>& args : samples) {
+        GPUSample sample = args[0].value<GPUSample>();
+        QVERIFY(sample.gpuId >= 0 && sample.gpuId < 5);
+        QVERIFY(sample.coreTemp >= 35 && sample.coreTemp <= 80);
+    }
+}
+
+void TestTelemetry::reconnectsAfterDrop() {
+    auto aggregator = std::make_unique<TelemetryAggregator>();
+    QVERIFY(aggregator->listen(0, QHostAddress::LocalHost));
+    quint16 port = aggregator->serverPort();
+
+    Host host("host-a", 1, port);
+    QTRY_COMPARE(aggregator->streamCount(), 1);
+    QTRY_VERIFY(host.collector.isConnected());
+
+    // The aggregator goes away and comes back on the same port
+    aggregator.reset();
+    QTRY_VERIFY(!host.collector.isConnected());
+    aggregator = std::make_unique<TelemetryAggregator>();
+    QVERIFY(aggregator->listen(port, QHostAddress::LocalHost));
+    QSignalSpy samples(aggregator.get(), &TelemetryAggregator::sampleReceived);
+
+    QTRY_VERIFY_WITH_TIMEOUT(samples.count() > 0, 10000);
+    QCOMPARE(aggregator->streamCount(), 1);
+}
+
+REGISTER_TEST(TestTelemetry)
+#include "tst_telemetry.moc"
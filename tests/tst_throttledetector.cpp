@@ -0,0 +1,136 @@
+#include <QTest>
+#include "testrunner.h"
+#include "include/throttledetector.h"
+
+class TestThrottleDetector : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void detectsCause_data();
+    void detectsCause();
+    void ignoresIdleClocks();
+    void endsWhenClocksRecover();
+    void holdsLongEvents();
+    void holdsForTimeNotSamples();
+    void holdToleratesJitter_data();
+    void holdToleratesJitter();
+
+private:
+    static const int SLOWDOWN_TEMP = 86;
+    static const qint64 SECOND = 1000000;
+
+    qint64 now = 0;
+
+    static GPUSample sample(int coreClock, int temp, int utilization = 99);
+    // Feeds samples interval µs apart until an event is reported, returns false if none was
+    bool feed(ThrottleDetector& detector, GPUSample sample, int count, ThrottleEvent& event, qint64 interval = SECOND);
+};
+
+void TestThrottleDetector::init() {
+    now = 0;
+}
+
+GPUSample TestThrottleDetector::sample(int coreClock, int temp, int utilization) {
+    GPUSample sample = {};
+    sample.coreClock = coreClock;
+    sample.coreTemp = temp;
+    sample.utilization = utilization;
+    return sample;
+}
+
+bool TestThrottleDetector::feed(ThrottleDetector& detector, GPUSample sample, int count, ThrottleEvent& event, qint64 interval) {
+    for (int i = 0; i < count; i++) {
+        now += interval;
+        sample.timestamp = now;
+        if (detector.addSample(sample, QDateTime::currentDateTime(), event))
+            return true;
+    }
+    return false;
+}
+
+void TestThrottleDetector::detectsCause_data() {
+    QTest::addColumn<int>("clock");
+    QTest::addColumn<int>("temp");
+    QTest::addColumn<int>("cause");
+    QTest::newRow("thermal") << 1700 << 84 << int(THERMAL_THROTTLE);
+    QTest::newRow("power") << 1700 << 65 << int(POWER_THROTTLE);
+    QTest::newRow("collapse") << 800 << 65 << int(CLOCK_COLLAPSE);
+}
+
+void TestThrottleDetector::detectsCause() {
+    QFETCH(int, clock);
+    QFETCH(int, temp);
+    QFETCH(int, cause);
+
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    QVERIFY(!feed(detector, sample(1900, 60), 20, event));
+    QVERIFY(feed(detector, sample(clock, temp), ThrottleDetector::HOLD_TIME / SECOND + 1, event));
+    QCOMPARE(int(event.cause), cause);
+    QVERIFY(!event.end.isValid());
+    QVERIFY(event.peakClock > 1850);
+}
+
+void TestThrottleDetector::ignoresIdleClocks() {
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    QVERIFY(!feed(detector, sample(1900, 60), 20, event));
+    QVERIFY(!feed(detector, sample(300, 40, 5), 20, event));
+}
+
+void TestThrottleDetector::endsWhenClocksRecover() {
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    feed(detector, sample(1900, 60), 20, event);
+    QVERIFY(feed(detector, sample(1700, 84), 10, event));
+    QVERIFY(!feed(detector, sample(1650, 85), 5, event));
+
+    QVERIFY(feed(detector, sample(1900, 80), 10, event));
+    QVERIFY(event.end.isValid());
+    QCOMPARE(event.minClock, 1650);
+    QCOMPARE(event.maxTemp, 85);
+}
+
+void TestThrottleDetector::holdsLongEvents() {
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    feed(detector, sample(1900, 60), 20, event);
+    QVERIFY(feed(detector, sample(1700, 84), 10, event));
+
+    // A throttled clock must not become the new peak and end the event
+    QVERIFY(!feed(detector, sample(1700, 84), 500, event));
+    QVERIFY(!event.end.isValid());
+}
+
+void TestThrottleDetector::holdsForTimeNotSamples() {
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    feed(detector, sample(1900, 60), 20, event);
+
+    // Many fast samples within the hold time do not report yet
+    QVERIFY(!feed(detector, sample(1700, 84), 10, event, ThrottleDetector::HOLD_TIME / 20));
+    QVERIFY(feed(detector, sample(1700, 84), 20, event, ThrottleDetector::HOLD_TIME / 20));
+    QCOMPARE(event.timestamp, now);
+}
+
+void TestThrottleDetector::holdToleratesJitter_data() {
+    QTest::addColumn<qint64>("interval");
+    QTest::newRow("early") << SECOND - 20000;
+    QTest::newRow("late") << SECOND + 20000;
+    QTest::newRow("tray early") << 5 * SECOND - 20000;
+}
+
+// A cause held for one sample interval is reported on the second sample, however the timestamps jitter
+void TestThrottleDetector::holdToleratesJitter() {
+    QFETCH(qint64, interval);
+    ThrottleDetector detector(SLOWDOWN_TEMP);
+    ThrottleEvent event;
+    feed(detector, sample(1900, 60), 20, event, interval);
+
+    QVERIFY(!feed(detector, sample(1700, 84), 1, event, interval));
+    QVERIFY(feed(detector, sample(1700, 84), 1, event, interval));
+}
+
+REGISTER_TEST(TestThrottleDetector)
+#include "tst_throttledetector.moc"
@@ -0,0 +1,40 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "testrunner.h"
+#include "fakenvtransport.h"
+#include "include/trayicon.h"
+
+class TestTrayIcon : public QObject {
+    Q_OBJECT
+
+private slots:
+    void createsWindowOnlyWhileOpen();
+};
+
+void TestTrayIcon::createsWindowOnlyWhileOpen() {
+    QTemporaryDir dir;
+    NvidiaControl nvidia(new FakeNvTransport());
+    Settings settings(dir.filePath("tray.config"));
+    SampleCache cache;
+    Sampler sampler(nvidia, cache);
+    ThrottleTimeline timeline(nvidia, sampler);
+    SampleHistory history(1);
+    sampler.start();
+
+    TrayIcon tray(nvidia, settings, sampler, timeline, history, 4000);
+    tray.show();
+    QCOMPARE(sampler.getInterval(), 4000);
+    QVERIFY(tray.window() == nullptr);
+
+    tray.showWindow();
+    QVERIFY(tray.window() != nullptr);
+    QCOMPARE(sampler.getInterval(), static_cast<int>(Sampler::SAMPLE_INTERVAL));
+
+    // Closing deletes the window and its charts, and slows sampling down again
+    tray.hideWindow();
+    QTRY_VERIFY(tray.window() == nullptr);
+    QCOMPARE(sampler.getInterval(), 4000);
+}
+
+REGISTER_TEST(TestTrayIcon)
+#include "tst_trayicon.moc"